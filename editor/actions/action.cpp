@@ -201,6 +201,7 @@ void Action::onSceneObjectDestroyed()
 {
     mObject = 0;
     mObjectName = "";
+    invalidateSceneCache();
     emit dataChanged();
 }
 
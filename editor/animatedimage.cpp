@@ -120,11 +120,11 @@ void AnimatedImage::checkTransparency()
     mTransparent = transparent;
 }
 
-QVariantMap AnimatedImage::toJsonObject()
+QList<QImage> AnimatedImage::frames(QList<int>* delays)
 {
-    QVariantMap data = Asset::toJsonObject();
+    QList<QImage> images;
     if (!mMovie || ! mMovie->isValid())
-        return data;
+        return images;
 
     int currFrame = -1;
     if (mMovie->state() == QMovie::Running) {
@@ -132,36 +132,52 @@ QVariantMap AnimatedImage::toJsonObject()
         mMovie->stop();
     }
 
-    QString format("JPG");
-    if (isTransparent())
-        format = "PNG";
-
-    QVariantList frames;
     mMovie->jumpToFrame(0);
     for(int i=0; i < mMovie->frameCount(); i++) {
         bool res =  mMovie->jumpToNextFrame();
         if (! res)
             continue;
-        QImage image = mMovie->currentImage();
+        images.append(mMovie->currentImage());
+        if (delays)
+            delays->append(mMovie->nextFrameDelay());
+    }
+
+    if (currFrame != -1) {
+        mMovie->jumpToFrame(currFrame);
+        mMovie->start();
+    }
+
+    return images;
+}
+
+QVariantMap AnimatedImage::toJsonObject()
+{
+    QVariantMap data = Asset::toJsonObject();
+    if (!mMovie || ! mMovie->isValid())
+        return data;
+
+    QString format("JPG");
+    if (isTransparent())
+        format = "PNG";
+
+    QVariantList frames;
+    QList<int> delays;
+    QList<QImage> images = this->frames(&delays);
+    for(int i=0; i < images.size(); i++) {
         QByteArray arr;
         QBuffer buf(&arr);
         buf.open(QIODevice::WriteOnly);
-        image.save(&buf, format.toLatin1());
+        images[i].save(&buf, format.toLatin1());
         buf.close();
         QByteArray imageData;
         imageData.append(QString("data:image/%1;base64,").arg(format.toLower()));
         imageData.append(arr.toBase64());
         QVariantMap frameData;
         frameData.insert("data", imageData);
-        frameData.insert("delay", mMovie->nextFrameDelay());
+        frameData.insert("delay", delays.value(i));
         frames.append(frameData);
     }
 
-    if (currFrame != -1) {
-        mMovie->jumpToFrame(currFrame);
-        mMovie->start();
-    }
-
     data.insert("frames", frames);
     return data;
 }
@@ -29,6 +29,7 @@ public:
     int frameNumber() const;
     QStringList framesNames() const;
     QRect rect() const;
+    QList<QImage> frames(QList<int>* delays=0);
     virtual QVariantMap toJsonObject();
     
 protected:
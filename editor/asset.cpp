@@ -1,6 +1,7 @@
 #include "asset.h"
 
 #include <QFileInfo>
+#include <QCryptographicHash>
 
 Asset::Asset(const QString& path, Type type)
 {
@@ -71,6 +72,17 @@ QVariantMap Asset::toJsonObject()
     return data;
 }
 
+QByteArray Asset::contentHash() const
+{
+    QFile file(mPath);
+    if (isNull() || ! file.open(QFile::ReadOnly))
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result();
+}
+
 bool Asset::isRemovable() const
 {
     return mRemovable;
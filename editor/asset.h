@@ -31,6 +31,7 @@ public:
     virtual bool isNull() const;
     virtual bool save(const QDir&, bool updatePath=false);
     virtual QVariantMap toJsonObject();
+    virtual QByteArray contentHash() const;
     bool isRemovable() const;
     void setRemovable(bool);
     bool remove();
@@ -1,17 +1,202 @@
 #include "assetmanager.h"
 
 #include <QFile>
+#include <QSaveFile>
 #include <QFontDatabase>
 #include <QJsonDocument>
 #include <QJsonParseError>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QBuffer>
+#include <QFileInfo>
+#include <QtConcurrentMap>
+#include <QtMath>
+#include <QPainter>
 
 #include "utils.h"
 #include "fontfile.h"
 #include "soundasset.h"
 #include "fontasset.h"
+#include "animatedimage.h"
+#include "atlaspacker.h"
+#include "fontsubsetter.h"
+#include "multisourceasset.h"
+#include "exportprogress.h"
+#include "tracer.h"
 
 static AssetManager* mInstance = new AssetManager();
 
+//only decodes still images, animated ones are handled by QMovie
+static QImage decodeImage(const QString& path)
+{
+    TraceSpan span("decode image", "assets", path);
+    QImageReader reader(path);
+    if (! reader.canRead() || (reader.supportsAnimation() && reader.imageCount() > 1))
+        return QImage();
+
+    return QImage(path);
+}
+
+struct ImageExportJob
+{
+    QString path;
+    QString name;
+    QString encodedName;
+    QSize maxSize;
+    int quality;
+    QByteArray format;
+    QString dir;
+    ExportProgress* progress;
+    //results
+    QImage image;
+    QString savedName;
+};
+
+//Copies a file, or writes the subset of a font when fontText isn't empty
+struct FileExportJob
+{
+    QString source;
+    QString destination;
+    QString fontText;
+    bool keepExisting;
+    ExportProgress* progress;
+};
+
+struct AtlasExportJob
+{
+    QSize size;
+    QList<QImage> sprites;
+    QList<QPoint> positions;
+    QString path;
+    ExportProgress* progress;
+};
+
+//Scales the image down to the biggest size it's shown at and re-encodes it if opaque,
+//keeping whichever file is smaller. Small results are returned to go into an atlas.
+static ImageExportJob transformImage(ImageExportJob job)
+{
+    QImage image(job.path);
+    if (image.isNull())
+        return job;
+
+    bool scaled = false;
+    if (job.maxSize.isValid()) {
+        qreal factor = qMax(qreal(job.maxSize.width()) / image.width(), qreal(job.maxSize.height()) / image.height());
+        if (factor < 1) {
+            image = image.scaled(qCeil(image.width() * factor), qCeil(image.height() * factor), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            scaled = true;
+        }
+    }
+
+    if (image.width() <= ATLAS_MAX_IMAGE_SIZE && image.height() <= ATLAS_MAX_IMAGE_SIZE) {
+        job.image = image;
+        return job;
+    }
+
+    QDir dir(job.dir);
+    QByteArray data;
+    qint64 size = QFileInfo(job.path).size();
+
+    //formats Qt can't write (e.g. gif) are kept as they are
+    if (scaled) {
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        QImageWriter writer(&buffer, QFileInfo(job.name).suffix().toLatin1());
+        if (writer.write(image))
+            size = data.size();
+        else {
+            data.clear();
+            image = QImage(job.path);
+            scaled = false;
+        }
+    }
+
+    //already in the target format, re-encoding would only lose quality
+    bool opaque = ! image.hasAlphaChannel() || ! ImageFile::isTransparent(image.convertToFormat(QImage::Format_ARGB32));
+    if (job.quality > 0 && opaque && (scaled || job.encodedName != job.name)) {
+        QByteArray encoded;
+        QBuffer buffer(&encoded);
+        buffer.open(QIODevice::WriteOnly);
+        QImageWriter writer(&buffer, job.format);
+        writer.setQuality(job.quality);
+        if (writer.write(image) && encoded.size() < size) {
+            data = encoded;
+            job.name = job.encodedName;
+        }
+    }
+
+    if (data.isEmpty())
+        return job;
+
+    QFile file(dir.absoluteFilePath(job.name));
+    if (file.open(QFile::WriteOnly) && file.write(data) == data.size())
+        job.savedName = job.name;
+
+    return job;
+}
+
+static ImageExportJob exportImage(ImageExportJob job)
+{
+    if (! job.progress->isCanceled())
+        job = transformImage(job);
+    job.progress->advance();
+    return job;
+}
+
+//Sources that can't be subset (e.g. eot or CFF fonts) are copied as they are
+static bool exportFile(FileExportJob job)
+{
+    if (job.progress->isCanceled())
+        return false;
+
+    if (QFile::exists(job.destination)) {
+        if (job.keepExisting) {
+            job.progress->advance();
+            return true;
+        }
+        QFile::remove(job.destination);
+    }
+
+    QByteArray subset;
+    if (! job.fontText.isEmpty()) {
+        QFile file(job.source);
+        if (file.open(QFile::ReadOnly))
+            subset = FontSubsetter::subset(file.readAll(), job.fontText + " ");
+    }
+
+    bool saved = false;
+    QFile destination(job.destination);
+    if (! subset.isEmpty() && destination.open(QFile::WriteOnly))
+        saved = destination.write(subset) == subset.size();
+    else
+        saved = QFile::copy(job.source, job.destination);
+
+    job.progress->advance();
+    return saved;
+}
+
+static bool exportAtlas(AtlasExportJob job)
+{
+    if (job.progress->isCanceled())
+        return false;
+
+    QImage atlas(job.size, QImage::Format_ARGB32_Premultiplied);
+    atlas.fill(Qt::transparent);
+    QPainter painter(&atlas);
+    for(int i=0; i < job.sprites.size(); i++)
+        painter.drawImage(job.positions[i], job.sprites[i]);
+    painter.end();
+
+    bool saved = atlas.save(job.path, "PNG");
+    job.progress->advance();
+    return saved;
+}
+
+static QByteArray contentHash(Asset* asset)
+{
+    return asset->contentHash();
+}
+
 AssetManager::AssetManager()
 {
     mTypeToPath.insert(Asset::Image, "");
@@ -23,6 +208,7 @@ AssetManager::AssetManager()
     mAudioFormats << "mp3" << "aac" << "ogg" << "oga" << "webm" << "wav" << "m4a" << "mp4";
     mVideoFormats << "mp4" << "m4v" << "webm" << "ogv" << "ogg";
     mFontFormats << "ttf" << "otf" << "eot" << "woff";
+    mKeepRemovedFiles = false;
 }
 
 AssetManager::~AssetManager()
@@ -137,7 +323,7 @@ Asset* AssetManager::_loadAsset(const QVariantMap& data, Asset::Type type)
     return asset;
 }
 
-Asset* AssetManager::_loadAsset(const QString& name, Asset::Type type)
+Asset* AssetManager::_loadAsset(const QString& name, Asset::Type type, const QImage& image)
 {
     QString path = absoluteFilePath(name);
 
@@ -146,7 +332,7 @@ Asset* AssetManager::_loadAsset(const QString& name, Asset::Type type)
 
     Asset* asset = 0;
     if (type == Asset::Image)
-        asset = ImageFile::create(path);
+        asset = ImageFile::create(path, image);
     else if (type == Asset::Font)
         asset = new FontAsset(path);
     else if (type == Asset::Audio)
@@ -267,6 +453,7 @@ QVariantMap AssetManager::readAssetsFile(const QString& filepath)
 
 void AssetManager::load(const QDir & dir, bool fromProject)
 {
+    TraceSpan span("load assets", "assets");
     QVariantMap data = readAssetsFile(dir.absoluteFilePath(ASSETS_FILE));
     if (data.isEmpty())
         return;
@@ -280,9 +467,17 @@ void AssetManager::load(const QDir & dir, bool fromProject)
     Asset* asset = 0;
 
     QVariantList imagesData = data.value("images").toList();
+    QStringList imagePaths;
     for(int i=0; i < imagesData.size(); i++) {
         item = imagesData[i].toMap();
-        asset = _loadAsset(item.value("name", "").toString(), Asset::Image);
+        imagePaths.append(absoluteFilePath(item.value("name", "").toString()));
+    }
+
+    //decoding is what makes opening big projects slow, so it's spread over the global thread pool.
+    //QPixmaps can only be created in the GUI thread, so the assets themselves are created here.
+    QList<QImage> images = QtConcurrent::blockingMapped<QList<QImage> >(imagePaths, decodeImage);
+    for(int i=0; i < imagePaths.size(); i++) {
+        asset = _loadAsset(imagePaths[i], Asset::Image, images.value(i));
         if (asset && fromProject)
             asset->setRemovable(true);
     }
@@ -316,12 +511,20 @@ void AssetManager::load(const QDir & dir, bool fromProject)
     }
 }
 
-void AssetManager::save(const QDir & dir, bool toProject)
+bool AssetManager::save(const QDir & dir, bool toProject, const AssetExportOptions& options)
 {
-    QVariantMap data;
-    QFile file(dir.absoluteFilePath(ASSETS_FILE));
-    if (! file.open(QFile::WriteOnly | QFile::Text))
-        return;
+    TraceSpan span("save assets", "assets");
+    QVariantMap data = options.extraData;
+    mErrorString = "";
+    //the old assets file is only replaced once everything else was exported
+    QSaveFile file(dir.absoluteFilePath(ASSETS_FILE));
+    if (! file.open(QFile::WriteOnly | QFile::Text)) {
+        mErrorString = QObject::tr("Couldn't write %1").arg(file.fileName());
+        return false;
+    }
+
+    ExportProgress localProgress;
+    ExportProgress* progress = options.progress ? options.progress : &localProgress;
 
     QVariantMap subdirs;
     subdirs.insert("images", mTypeToPath.value(Asset::Image));
@@ -330,44 +533,238 @@ void AssetManager::save(const QDir & dir, bool toProject)
     data.insert("subdirs", subdirs);
 
     QList<Asset*> images = this->assets(Asset::Image);
+    QList<Asset*> sounds = this->assets(Asset::Audio);
+    QList<Asset*> fonts = this->assets(Asset::Font);
+
+    //identical files are only exported once, the engine maps the other names to it
+    QHash<Asset*, QByteArray> hashes;
+    bool optimize = ! toProject && options.optimize;
+    if (optimize) {
+        progress->startStage("compare assets");
+        QList<Asset*> hashed;
+        foreach(Asset* asset, images + sounds) {
+            if (! options.excluded.contains(asset->name()))
+                hashed.append(asset);
+        }
+        QList<QByteArray> results = QtConcurrent::blockingMapped<QList<QByteArray> >(hashed, contentHash);
+        for(int i=0; i < hashed.size(); i++)
+            hashes.insert(hashed[i], results.value(i));
+        progress->finishStage("compare assets");
+    }
+
+    QHash<QByteArray, Asset*> savedImages;
+    QHash<QByteArray, Asset*> savedSounds;
+    QVariantMap aliases;
+    Asset* original = 0;
+
+    bool encode = options.imageQuality > 0 && options.imageQuality <= 100 &&
+                  QImageWriter::supportedImageFormats().contains(options.imageFormat);
+    QList<ImageFile*> atlasImages;
+    QList<ImageExportJob> imageJobs;
+    QList<ImageFile*> jobImages;
+    QList<FileExportJob> fileJobs;
+    QSet<QString> encodedNames;
+    QStringList atlases;
     QVariantList imagesData;
     for(int i=0; i < images.size(); i++) {
+        if (options.excluded.contains(images[i]->name()))
+            continue;
+
+        original = optimize ? savedDuplicate(images[i], hashes.value(images[i]), savedImages) : 0;
+        if (original) {
+            aliases.insert(images[i]->name(), original->name());
+            continue;
+        }
+
+        ImageFile* image = dynamic_cast<ImageFile*>(images[i]);
+        if (optimize && image && isAtlasCandidate(image)) {
+            atlasImages.append(image);
+            continue;
+        }
+
+        //big still images are scaled and re-encoded in parallel below
+        if (optimize && image && ! image->isAnimated() && (encode || options.imageSizes.contains(image->name()))) {
+            ImageExportJob job;
+            job.path = image->path();
+            job.name = image->name();
+            job.maxSize = options.imageSizes.value(image->name());
+            job.quality = encode ? options.imageQuality : 0;
+            job.format = options.imageFormat;
+            job.dir = dir.absolutePath();
+            job.progress = progress;
+            job.encodedName = QFileInfo(job.name).completeBaseName() + "." + options.imageFormat;
+            while(job.encodedName != job.name && (encodedNames.contains(job.encodedName) || ! isNameUnique(job.encodedName)))
+                job.encodedName = Utils::incrementFileName(job.encodedName);
+            encodedNames.insert(job.encodedName);
+            imageJobs.append(job);
+            jobImages.append(image);
+            continue;
+        }
+
         imagesData.append(images[i]->toJsonObject());
-        bool saved = images[i]->save(dir, toProject);
-        if (saved && toProject)
+        if (! toProject) {
+            fileJobs.append(fileExportJobs(images[i], dir, progress, QString(), ! optimize));
+            continue;
+        }
+
+        if (images[i]->save(dir, toProject))
             images[i]->setRemovable(true);
     }
 
-    QList<Asset*> sounds = this->assets(Asset::Audio);
     QVariantList soundsData;
     for(int i=0; i < sounds.size(); i++) {
+        if (options.excluded.contains(sounds[i]->name()))
+            continue;
+
+        original = optimize ? savedDuplicate(sounds[i], hashes.value(sounds[i]), savedSounds) : 0;
+        if (original) {
+            aliases.insert(sounds[i]->name(), original->name());
+            continue;
+        }
+
         soundsData.append(sounds[i]->toJsonObject());
+        if (! toProject) {
+            fileJobs.append(fileExportJobs(sounds[i], dir, progress, QString(), ! optimize));
+            continue;
+        }
+
         sounds[i]->save(dir, toProject);
-        if (toProject)
-            sounds[i]->setRemovable(true);
+        sounds[i]->setRemovable(true);
     }
 
-    QList<Asset*> fonts = this->assets(Asset::Font);
     QVariantList fontsData;
     for(int i=0; i < fonts.size(); i++) {
         fontsData.append(fonts[i]->toJsonObject());
+        if (! toProject) {
+            FontAsset* font = dynamic_cast<FontAsset*>(fonts[i]);
+            QString text = font && optimize ? options.fontCharacters.value(font->fontFamily().toLower()) : QString();
+            fileJobs.append(fileExportJobs(fonts[i], dir, progress, text, ! optimize));
+            continue;
+        }
+
         fonts[i]->save(dir, toProject);
-        if (toProject)
-            fonts[i]->setRemovable(true);
+        fonts[i]->setRemovable(true);
+    }
+
+    //copies and image transforms run together on the thread pool
+    progress->startStage("copy files");
+    progress->addWork(fileJobs.size() + imageJobs.size());
+    QFuture<bool> filesFuture = QtConcurrent::mapped(fileJobs, exportFile);
+    progress->startStage("transform images");
+    QFuture<ImageExportJob> imagesFuture = QtConcurrent::mapped(imageJobs, exportImage);
+    progress->waitFor(imagesFuture);
+    progress->finishStage("transform images");
+
+    QHash<ImageFile*, QImage> decoded;
+    QList<FileExportJob> fallbackJobs;
+    for(int i=0; i < imageJobs.size() && ! progress->isCanceled(); i++) {
+        ImageFile* image = jobImages[i];
+        ImageExportJob job = imagesFuture.resultAt(i);
+        if (! job.image.isNull()) {
+            atlasImages.append(image);
+            decoded.insert(image, job.image);
+            continue;
+        }
+
+        imagesData.append(image->toJsonObject());
+        //the engine finds renamed files through the aliases
+        if (job.savedName.isEmpty())
+            fallbackJobs.append(fileExportJobs(image, dir, progress));
+        else if (job.savedName != image->name())
+            aliases.insert(image->name(), job.savedName);
+    }
+
+    //images that couldn't be transformed are copied as they are
+    progress->addWork(fallbackJobs.size());
+    QFuture<bool> fallbackFuture = QtConcurrent::mapped(fallbackJobs, exportFile);
+
+    //duplicates of renamed images point to the new file
+    foreach(const QString& name, aliases.keys()) {
+        QString target = aliases.value(name).toString();
+        if (aliases.contains(target))
+            aliases.insert(name, aliases.value(target));
+    }
+
+    //small images and animation frames go into a few atlases instead of separate files
+    QStringList failedFiles;
+    if (! atlasImages.isEmpty() && ! progress->isCanceled()) {
+        progress->startStage("pack atlases");
+        imagesData.append(saveAtlases(atlasImages, dir, atlases, decoded, progress, failedFiles));
+        progress->finishStage("pack atlases");
+    }
+
+    progress->waitFor(filesFuture);
+    progress->waitFor(fallbackFuture);
+    progress->finishStage("copy files");
+
+    if (progress->isCanceled()) {
+        file.cancelWriting();
+        return false;
+    }
+
+    for(int i=0; i < fileJobs.size(); i++) {
+        if (! filesFuture.resultAt(i))
+            failedFiles.append(fileJobs[i].destination);
+    }
+    for(int i=0; i < fallbackJobs.size(); i++) {
+        if (! fallbackFuture.resultAt(i))
+            failedFiles.append(fallbackJobs[i].destination);
+    }
+
+    //the engine would fail to load whatever is missing
+    if (! failedFiles.isEmpty()) {
+        mErrorString = QObject::tr("Couldn't write these files:\n%1").arg(failedFiles.join("\n"));
+        file.cancelWriting();
+        return false;
     }
 
     data.insert("images", imagesData);
     data.insert("sounds", soundsData);
     data.insert("fonts", fontsData);
+    if (! aliases.isEmpty())
+        data.insert("aliases", aliases);
+    if (! atlases.isEmpty())
+        data.insert("atlases", atlases);
 
     file.write("game.assets = ");
     file.write(QJsonDocument::fromVariant(data).toJson(QJsonDocument::Compact));
-    file.close();
+    if (! file.commit()) {
+        mErrorString = QObject::tr("Couldn't write %1").arg(file.fileName());
+        return false;
+    }
 
     saveFontFaces(fonts, dir);
 
     if (toProject)
         cleanup();
+
+    return true;
+}
+
+QList<FileExportJob> AssetManager::fileExportJobs(Asset* asset, const QDir& dir, ExportProgress* progress, const QString& fontText, bool keepExisting) const
+{
+    QList<Asset*> files;
+    MultiSourceAsset* multiSource = dynamic_cast<MultiSourceAsset*>(asset);
+    if (multiSource)
+        files = multiSource->sources();
+    else if (asset->isValid())
+        files.append(asset);
+
+    QList<FileExportJob> jobs;
+    foreach(Asset* file, files) {
+        if (! file || ! file->isValid())
+            continue;
+
+        FileExportJob job;
+        job.source = file->path();
+        job.destination = dir.absoluteFilePath(file->name());
+        job.fontText = fontText;
+        job.keepExisting = keepExisting;
+        job.progress = progress;
+        jobs.append(job);
+    }
+
+    return jobs;
 }
 
 void AssetManager::saveFontFaces(const QList<Asset*>& fonts, const QDir& dir)
@@ -403,8 +800,22 @@ QList<int> AssetManager::fontsIds()
     return ids;
 }
 
+bool AssetManager::keepRemovedFiles() const
+{
+    return mKeepRemovedFiles;
+}
+
+//While set, files of removed assets are left in the project on save, so undo can bring them back
+void AssetManager::setKeepRemovedFiles(bool keep)
+{
+    mKeepRemovedFiles = keep;
+}
+
 void AssetManager::cleanup()
 {
+    if (mKeepRemovedFiles)
+        return;
+
     foreach(const QString& path, mFilesToRemove) {
         if (QFile::exists(path))
             QFile::remove(path);
@@ -419,6 +830,151 @@ void AssetManager::clear()
     clearAssets();
 }
 
+//Why the last save failed, if it did
+QString AssetManager::errorString() const
+{
+    return mErrorString;
+}
+
+bool AssetManager::isAtlasCandidate(ImageFile* image) const
+{
+    if (image->isNull())
+        return false;
+
+    if (image->width() > ATLAS_MAX_IMAGE_SIZE || image->height() > ATLAS_MAX_IMAGE_SIZE)
+        return false;
+
+    //atlases are lossless, photos and other opaque images are smaller re-encoded on their own
+    QString suffix = QFileInfo(image->path()).suffix().toLower();
+    if (suffix == "jpg" || suffix == "jpeg")
+        return false;
+
+    return image->isAnimated() || image->pixmap().hasAlphaChannel();
+}
+
+QVariantList AssetManager::saveAtlases(const QList<ImageFile*>& images, const QDir& dir, QStringList& atlases, const QHash<ImageFile*, QImage>& decoded, ExportProgress* progress, QStringList& failedFiles)
+{
+    QVariantList imagesData;
+    QList<QImage> sprites;
+    QList<int> owners;
+    QList<QList<int> > delays;
+
+    for(int i=0; i < images.size(); i++) {
+        QList<QImage> frames;
+        QList<int> frameDelays;
+        AnimatedImage* animation = dynamic_cast<AnimatedImage*>(images[i]);
+
+        if (animation)
+            frames = animation->frames(&frameDelays);
+        else if (decoded.contains(images[i]))
+            frames.append(decoded.value(images[i]));
+        else
+            frames.append(images[i]->pixmap().toImage());
+
+        foreach(const QImage& frame, frames) {
+            sprites.append(frame);
+            owners.append(i);
+        }
+        delays.append(frameDelays);
+    }
+
+    //bigger sprites first, they are the hardest to fit
+    QList<QPair<int, int> > order;
+    for(int i=0; i < sprites.size(); i++)
+        order.append(qMakePair(-sprites[i].width() * sprites[i].height(), i));
+    qSort(order);
+
+    AtlasPacker packer(QSize(ATLAS_SIZE, ATLAS_SIZE));
+    QVector<int> bins(sprites.size(), -1);
+    QVector<QRect> rects(sprites.size());
+    for(int i=0; i < order.size(); i++) {
+        int index = order[i].second;
+        packer.insert(sprites[index].size(), &bins[index], &rects[index]);
+    }
+
+    //atlases are drawn and encoded in parallel
+    QList<AtlasExportJob> jobs;
+    for(int i=0; i < packer.binCount(); i++) {
+        AtlasExportJob job;
+        job.size = packer.binSize(i);
+        job.progress = progress;
+        for(int j=0; j < sprites.size(); j++) {
+            if (bins[j] == i) {
+                job.sprites.append(sprites[j]);
+                job.positions.append(rects[j].topLeft());
+            }
+        }
+
+        QString name = uniqueName(QString("atlas%1.png").arg(i));
+        job.path = dir.absoluteFilePath(name);
+        atlases.append(name);
+        jobs.append(job);
+    }
+
+    progress->addWork(jobs.size());
+    QFuture<bool> atlasesFuture = QtConcurrent::mapped(jobs, exportAtlas);
+    progress->waitFor(atlasesFuture);
+    for(int i=0; i < jobs.size() && ! progress->isCanceled(); i++) {
+        if (! atlasesFuture.resultAt(i))
+            failedFiles.append(jobs[i].path);
+    }
+
+    int sprite = 0;
+    for(int i=0; i < images.size(); i++) {
+        QVariantMap data = images[i]->Asset::toJsonObject();
+        QVariantList frames;
+        bool packed = true;
+
+        for(; sprite < sprites.size() && owners[sprite] == i; sprite++) {
+            QVariantMap frame;
+            QRect rect = rects[sprite];
+            if (bins[sprite] == -1)
+                packed = false;
+            frame.insert("atlas", bins[sprite]);
+            frame.insert("rect", QVariantList() << rect.x() << rect.y() << rect.width() << rect.height());
+            if (images[i]->isAnimated())
+                frame.insert("delay", delays[i].value(frames.size()));
+            frames.append(frame);
+        }
+
+        //fallback to a separate file
+        if (! packed || frames.isEmpty()) {
+            QString path = dir.absoluteFilePath(images[i]->name());
+            if (QFile::exists(path))
+                QFile::remove(path);
+            imagesData.append(images[i]->toJsonObject());
+            if (! images[i]->save(dir))
+                failedFiles.append(path);
+            continue;
+        }
+
+        if (images[i]->isAnimated()) {
+            data.insert("frames", frames);
+        }
+        else {
+            QVariantMap frame = frames.first().toMap();
+            data.insert("atlas", frame.value("atlas"));
+            data.insert("rect", frame.value("rect"));
+        }
+
+        imagesData.append(data);
+    }
+
+    return imagesData;
+}
+
+Asset* AssetManager::savedDuplicate(Asset* asset, const QByteArray& hash, QHash<QByteArray, Asset*>& saved) const
+{
+    if (hash.isEmpty())
+        return 0;
+
+    if (saved.contains(hash))
+        return saved.value(hash);
+
+    saved.insert(hash, asset);
+    return 0;
+}
+
 void AssetManager::addAsset(Asset * asset, Asset::Type type)
 {
     if (asset && ! isNameUnique(asset->name()))
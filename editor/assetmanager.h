@@ -5,12 +5,35 @@
 #include <QVariantMap>
 #include <QString>
 #include <QSet>
+#include <QSize>
 
 #include "asset.h"
 #include "imagefile.h"
 
 #define FONTFACES_FILE "fontfaces.css"
 #define ASSETS_FILE "assets.js"
+#define ATLAS_SIZE 2048
+#define ATLAS_MAX_IMAGE_SIZE 512
+
+class ExportProgress;
+struct FileExportJob;
+
+//Set by the Exporter. imageSizes holds the biggest size each image is shown at;
+//opaque images are re-encoded as imageFormat when imageQuality is between 1 and 100.
+//Fonts are reduced to the characters in fontCharacters (by lower case family).
+//Exports run on the thread pool and report to progress, which can cancel them.
+struct AssetExportOptions
+{
+    QVariantMap extraData;
+    QStringList excluded;
+    QHash<QString, QSize> imageSizes;
+    QHash<QString, QString> fontCharacters;
+    int imageQuality;
+    QByteArray imageFormat;
+    ExportProgress* progress;
+    bool optimize;
+    AssetExportOptions() : imageQuality(0), imageFormat("jpg"), progress(0), optimize(true) {}
+};
 
 class AssetManager
 {
@@ -22,6 +45,8 @@ class AssetManager
     QStringList mAudioFormats;
     QStringList mVideoFormats;
     QStringList mFontFormats;
+    bool mKeepRemovedFiles;
+    QString mErrorString;
 
 public:
     AssetManager();
@@ -29,7 +54,8 @@ public:
     static AssetManager* instance();
     static void destroy();
     void load(const QDir&, bool fromProject=false);
-    void save(const QDir&, bool toProject=false);
+    bool save(const QDir&, bool toProject=false, const AssetExportOptions& options=AssetExportOptions());
+    QString errorString() const;
     Asset* asset(const QString&, Asset::Type type=Asset::Unknown) const;
     QList<Asset*> assets() const;
     QList<Asset*> assets(Asset::Type type) const;
@@ -45,15 +71,21 @@ public:
     QString uniqueName(QString) const;
     QString absoluteFilePath(const QString&, Asset::Type=Asset::Unknown);
     void setLoadPath(const QString&);
+    bool keepRemovedFiles() const;
+    void setKeepRemovedFiles(bool);
 
 protected:
     QVariantMap readAssetsFile(const QString&);
     void saveFontFaces(const QList<Asset*>&, const QDir&);
     void updateRefCount();
-    Asset* _loadAsset(const QString&, Asset::Type);
+    Asset* _loadAsset(const QString&, Asset::Type, const QImage& image=QImage());
     Asset* _loadAsset(const QVariantMap&, Asset::Type);
     Asset::Type guessType(const QString&) const;
     void addAsset(Asset*, Asset::Type);
+    Asset* savedDuplicate(Asset*, const QByteArray&, QHash<QByteArray, Asset*>&) const;
+    QList<FileExportJob> fileExportJobs(Asset*, const QDir&, ExportProgress*, const QString& fontText=QString(), bool keepExisting=false) const;
+    bool isAtlasCandidate(ImageFile*) const;
+    QVariantList saveAtlases(const QList<ImageFile*>&, const QDir&, QStringList&, const QHash<ImageFile*, QImage>&, ExportProgress*, QStringList&);
 
 private:
     void cleanup();
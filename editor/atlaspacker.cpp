@@ -0,0 +1,143 @@
+#include "atlaspacker.h"
+
+#include <climits>
+
+AtlasPacker::AtlasPacker(const QSize& size, int padding)
+{
+    mSize = size;
+    mPadding = padding;
+}
+
+AtlasPacker::~AtlasPacker()
+{
+}
+
+bool AtlasPacker::insert(const QSize& size, int* bin, QRect* rect)
+{
+    QSize padded(size.width() + mPadding, size.height() + mPadding);
+    if (size.isEmpty() || padded.width() > mSize.width() || padded.height() > mSize.height())
+        return false;
+
+    QRect placed;
+    for(int i=0; i < mBins.size(); i++) {
+        if (insert(mBins[i], padded, &placed)) {
+            *bin = i;
+            *rect = QRect(placed.topLeft(), size);
+            return true;
+        }
+    }
+
+    Bin newBin;
+    newBin.freeRects.append(QRect(QPoint(0, 0), mSize));
+    mBins.append(newBin);
+    insert(mBins.last(), padded, &placed);
+    *bin = mBins.size()-1;
+    *rect = QRect(placed.topLeft(), size);
+    return true;
+}
+
+bool AtlasPacker::insert(Bin& bin, const QSize& size, QRect* rect)
+{
+    int bestShortSide = INT_MAX;
+    int bestLongSide = INT_MAX;
+    int bestIndex = -1;
+
+    for(int i=0; i < bin.freeRects.size(); i++) {
+        const QRect& freeRect = bin.freeRects.at(i);
+        if (freeRect.width() < size.width() || freeRect.height() < size.height())
+            continue;
+
+        int leftoverHoriz = freeRect.width() - size.width();
+        int leftoverVert = freeRect.height() - size.height();
+        int shortSide = qMin(leftoverHoriz, leftoverVert);
+        int longSide = qMax(leftoverHoriz, leftoverVert);
+
+        if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+            bestIndex = i;
+        }
+    }
+
+    if (bestIndex == -1)
+        return false;
+
+    QRect placed(bin.freeRects.at(bestIndex).topLeft(), size);
+    splitFreeRects(bin, placed);
+    pruneFreeRects(bin);
+
+    bin.usedSize = bin.usedSize.expandedTo(QSize(placed.x() + placed.width(), placed.y() + placed.height()));
+    *rect = placed;
+    return true;
+}
+
+void AtlasPacker::splitFreeRects(Bin& bin, const QRect& used)
+{
+    QList<QRect> freeRects;
+    int usedRight = used.x() + used.width();
+    int usedBottom = used.y() + used.height();
+
+    foreach(const QRect& freeRect, bin.freeRects) {
+        if (! freeRect.intersects(used)) {
+            freeRects.append(freeRect);
+            continue;
+        }
+
+        int freeRight = freeRect.x() + freeRect.width();
+        int freeBottom = freeRect.y() + freeRect.height();
+
+        if (used.x() > freeRect.x())
+            freeRects.append(QRect(freeRect.x(), freeRect.y(), used.x() - freeRect.x(), freeRect.height()));
+        if (usedRight < freeRight)
+            freeRects.append(QRect(usedRight, freeRect.y(), freeRight - usedRight, freeRect.height()));
+        if (used.y() > freeRect.y())
+            freeRects.append(QRect(freeRect.x(), freeRect.y(), freeRect.width(), used.y() - freeRect.y()));
+        if (usedBottom < freeBottom)
+            freeRects.append(QRect(freeRect.x(), usedBottom, freeRect.width(), freeBottom - usedBottom));
+    }
+
+    bin.freeRects = freeRects;
+}
+
+//removes free rectangles that are completely inside other free rectangles
+void AtlasPacker::pruneFreeRects(Bin& bin)
+{
+    QList<QRect>& rects = bin.freeRects;
+
+    for(int i=0; i < rects.size(); i++) {
+        for(int j=i+1; j < rects.size(); j++) {
+            if (rects.at(j).contains(rects.at(i))) {
+                rects.removeAt(i);
+                --i;
+                break;
+            }
+
+            if (rects.at(i).contains(rects.at(j))) {
+                rects.removeAt(j);
+                --j;
+            }
+        }
+    }
+}
+
+int AtlasPacker::binCount() const
+{
+    return mBins.size();
+}
+
+QSize AtlasPacker::binSize(int index) const
+{
+    if (index < 0 || index >= mBins.size())
+        return QSize();
+    return mBins.at(index).usedSize;
+}
+
+QSize AtlasPacker::maxSize() const
+{
+    return mSize;
+}
+
+void AtlasPacker::clear()
+{
+    mBins.clear();
+}
@@ -0,0 +1,37 @@
+#ifndef ATLASPACKER_H
+#define ATLASPACKER_H
+
+#include <QList>
+#include <QRect>
+#include <QSize>
+
+//Packs rectangles into fixed size bins using the max-rects algorithm
+//(best short side fit). A new bin is opened when a rectangle doesn't fit in any of the others.
+class AtlasPacker
+{
+    struct Bin {
+        QList<QRect> freeRects;
+        QSize usedSize;
+    };
+
+    QSize mSize;
+    int mPadding;
+    QList<Bin> mBins;
+
+public:
+    AtlasPacker(const QSize& size=QSize(2048, 2048), int padding=1);
+    virtual ~AtlasPacker();
+
+    bool insert(const QSize&, int* bin, QRect* rect);
+    int binCount() const;
+    QSize binSize(int) const;
+    QSize maxSize() const;
+    void clear();
+
+private:
+    bool insert(Bin&, const QSize&, QRect*);
+    void splitFreeRects(Bin&, const QRect&);
+    void pruneFreeRects(Bin&);
+};
+
+#endif // ATLASPACKER_H
@@ -0,0 +1,96 @@
+#include "autosaver.h"
+
+#include <QDir>
+#include <QFile>
+#include <QtConcurrentRun>
+
+#include "exporter.h"
+#include "tracer.h"
+
+static bool writeAutosave(const QVariantMap& data, const QString& path)
+{
+    TraceSpan span("autosave", "project", path);
+    return Exporter::writeGameFile(data, path);
+}
+
+AutoSaver::AutoSaver(QObject *parent) :
+    QObject(parent)
+{
+    connect(&mWatcher, SIGNAL(finished()), this, SLOT(onWriteFinished()));
+}
+
+AutoSaver::~AutoSaver()
+{
+    mWatcher.waitForFinished();
+}
+
+bool AutoSaver::save(const QVariantMap& data, const QString& path)
+{
+    if (isSaving())
+        return false;
+
+    if (path == mPath && data == mSavedData)
+        return false;
+
+    //nothing changed since the project was saved, an older autosave is out of date
+    if (path == mBaselinePath && data == mBaseline) {
+        if (QFile::exists(path))
+            discard(path);
+        return false;
+    }
+
+    mSavedData = data;
+    mPath = path;
+    mWatcher.setFuture(QtConcurrent::run(writeAutosave, data, path));
+    return true;
+}
+
+bool AutoSaver::isSaving() const
+{
+    return mWatcher.isRunning();
+}
+
+void AutoSaver::waitForFinished()
+{
+    mWatcher.waitForFinished();
+}
+
+//removes the autosave once the project was saved or its changes were dropped
+void AutoSaver::discard(const QString& path)
+{
+    waitForFinished();
+    if (QFile::exists(path))
+        QFile::remove(path);
+    if (path == mPath) {
+        mSavedData.clear();
+        mPath = "";
+    }
+}
+
+//the data last saved to or read from the project that autosaves to path
+void AutoSaver::setBaseline(const QVariantMap& data, const QString& path)
+{
+    mBaseline = data;
+    mBaselinePath = path;
+}
+
+QString AutoSaver::autosavePath(const QString& projectPath)
+{
+    return QDir(projectPath).absoluteFilePath(AUTOSAVE_FILENAME);
+}
+
+void AutoSaver::onWriteFinished()
+{
+    if (mWatcher.isCanceled() || mPath.isEmpty())
+        return;
+
+    if (mWatcher.result()) {
+        emit saved(mPath);
+    }
+    else {
+        //try again on the next snapshot
+        QString path = mPath;
+        mSavedData.clear();
+        emit failed(path);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef AUTOSAVER_H
+#define AUTOSAVER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QString>
+#include <QVariantMap>
+
+#define AUTOSAVE_FILENAME "game_data.autosave.js"
+#define AUTOSAVE_INTERVAL 5
+#define AUTOSAVE_ASSETS_KEY "autosaveAssets"
+
+//Writes snapshots of the game data on the thread pool. The snapshot is taken on the
+//GUI thread and, being implicitly shared, stays untouched while it's encoded and written.
+//Snapshots equal to the last one written or to the last explicit save (the baseline)
+//are skipped, as are the ones taken while a write is still running.
+class AutoSaver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AutoSaver(QObject *parent = 0);
+    virtual ~AutoSaver();
+
+    bool save(const QVariantMap&, const QString&);
+    bool isSaving() const;
+    void waitForFinished();
+    void discard(const QString&);
+    void setBaseline(const QVariantMap&, const QString&);
+
+    static QString autosavePath(const QString&);
+
+signals:
+    void saved(const QString&);
+    void failed(const QString&);
+
+private slots:
+    void onWriteFinished();
+
+private:
+    QFutureWatcher<bool> mWatcher;
+    QVariantMap mSavedData;
+    QString mPath;
+    QVariantMap mBaseline;
+    QString mBaselinePath;
+};
+
+#endif // AUTOSAVER_H
@@ -0,0 +1,10 @@
+# Headless exporter, shares all the sources with the editor.
+# Build it in its own directory, e.g.: qmake ../editor/belle-cli.pro && make
+include(belle.pro)
+
+TARGET = belle-cli
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES -= main.cpp
+SOURCES += belle_cli.cpp
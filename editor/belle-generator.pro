@@ -0,0 +1,12 @@
+# Generates synthetic projects of any size for scale testing, shares all the sources with the editor.
+# Build it in its own directory, e.g.: qmake ../editor/belle-generator.pro && make
+include(belle.pro)
+
+TARGET = belle-generator
+CONFIG += console
+CONFIG -= app_bundle
+
+HEADERS += projectgenerator.h
+SOURCES -= main.cpp
+SOURCES += belle_generator.cpp \
+    projectgenerator.cpp
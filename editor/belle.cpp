@@ -32,6 +32,7 @@
 #include <QTextCodec>
 #include <QProcess>
 #include <QJsonDocument>
+#include <QProgressDialog>
 
 #include "object.h"
 #include "add_character_dialog.h"
@@ -64,6 +65,11 @@
 #include "slotbutton.h"
 #include "font.h"
 #include "fontlibrary.h"
+#include "exportprogress.h"
+#include "gamedatadelta.h"
+#include "gzipwriter.h"
+#include "tracer.h"
+#include "undohistory.h"
 
 static Belle* mInstance = 0;
 
@@ -80,6 +86,7 @@ Belle::Belle(QWidget *widget)
 
     mHttpServer.setServerPort(8000);
     mDisableClick = false;
+    mExporting = false;
     QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
 
     Scene::setWidth(WIDTH);
@@ -106,6 +113,7 @@ Belle::Belle(QWidget *widget)
     mUi.scenesWidget->setIconSize(QSize(64, 48));
     mUi.pauseScenesWidget->setIconSize(QSize(64, 48));
 
+    Tracer::init();
     GameObjectFactory::init();
     EditorWidgetFactory::init();
     FontLibrary::init();
@@ -213,6 +221,29 @@ Belle::Belle(QWidget *widget)
     connect(mUi.aboutAction, SIGNAL(triggered()), this, SLOT(showAboutDialog()));
     connect(mUi.saveProjectAction, SIGNAL(triggered()), this, SLOT(saveProject()));
     connect(mUi.exportProject, SIGNAL(triggered()), this, SLOT(exportProject()));
+    connect(mUi.showPaintStatisticsAction, SIGNAL(toggled(bool)), mDrawingSurfaceWidget, SLOT(setShowPaintStatistics(bool)));
+    mUi.recordTraceAction->setChecked(Tracer::isEnabled());
+    connect(mUi.recordTraceAction, SIGNAL(toggled(bool)), this, SLOT(onRecordTraceToggled(bool)));
+
+    //undo history
+    UndoHistory* undoHistory = UndoHistory::instance();
+    undoHistory->setEnabled(true);
+    undoHistory->watch(ResourceManager::instance());
+    mUi.undoAction->setEnabled(false);
+    mUi.redoAction->setEnabled(false);
+    connect(mUi.undoAction, SIGNAL(triggered()), undoHistory, SLOT(undo()));
+    connect(mUi.redoAction, SIGNAL(triggered()), undoHistory, SLOT(redo()));
+    connect(undoHistory->undoStack(), SIGNAL(canUndoChanged(bool)), mUi.undoAction, SLOT(setEnabled(bool)));
+    connect(undoHistory->undoStack(), SIGNAL(canRedoChanged(bool)), mUi.redoAction, SLOT(setEnabled(bool)));
+    connect(undoHistory, SIGNAL(applied()), this, SLOT(onUndoHistoryApplied()));
+
+    //autosave
+    mAutoSaver = new AutoSaver(this);
+    mAutoSaveTimer = new QTimer(this);
+    mAutoSaveTimer->setInterval(AUTOSAVE_INTERVAL * 60 * 1000);
+    connect(mAutoSaveTimer, SIGNAL(timeout()), this, SLOT(autoSave()));
+    connect(mAutoSaver, SIGNAL(saved(const QString&)), this, SLOT(onAutoSaved(const QString&)));
+    connect(mAutoSaver, SIGNAL(failed(const QString&)), this, SLOT(onAutoSaveFailed(const QString&)));
 
     //scene's buttons
     connect(mUi.upSceneBtn, SIGNAL(clicked()), this, SLOT(onSceneUpped()));
@@ -250,6 +281,8 @@ Belle::Belle(QWidget *widget)
 
     restoreSettings();
     Engine::loadPath();
+    if (mAutoSaveTimer->interval() > 0)
+        mAutoSaveTimer->start();
 }
 
 void Belle::afterShow()
@@ -295,6 +328,8 @@ void Belle::saveSettings()
         mSettings->setValue("browser", Engine::browserPath());
     mSettings->setValue("useBuiltinBrowser", Engine::useBuiltinBrowser());
     mSettings->endGroup();
+    mSettings->setValue("undoMemoryBudget", UndoHistory::instance()->memoryBudget() / (1024 * 1024));
+    mSettings->setValue("autoSaveInterval", mAutoSaveTimer->interval() / (60 * 1000));
 }
 
 void Belle::restoreSettings()
@@ -319,10 +354,26 @@ void Belle::restoreSettings()
         mShowBuiltinBrowserMessage = mSettings->value("showBuiltinBrowserMessage").toBool();
     if (mSettings->contains("showWebSafeFontsMessage"))
         ChooseFontWidget::setShowWebSafeFontsMessage(mSettings->value("showWebSafeFontsMessage").toBool());
+    //in megabytes
+    if (mSettings->contains("undoMemoryBudget"))
+        UndoHistory::instance()->setMemoryBudget(mSettings->value("undoMemoryBudget").toLongLong() * 1024 * 1024);
+    //in minutes, 0 disables autosave
+    if (mSettings->contains("autoSaveInterval"))
+        mAutoSaveTimer->setInterval(qMax(mSettings->value("autoSaveInterval").toInt(), 0) * 60 * 1000);
 }
 
 Belle::~Belle()
 {
+    //traces started from the environment are written when the editor closes
+    QString tracePath = QString::fromLocal8Bit(qgetenv(TRACE_ENV_VARIABLE));
+    if (! tracePath.isEmpty() && Tracer::isEnabled())
+        Tracer::save(tracePath);
+
+    //closing the project isn't an edit
+    UndoHistory::instance()->setEnabled(false);
+    mAutoSaveTimer->stop();
+    mAutoSaver->waitForFinished();
+
     if (mDefaultSceneManager)
         delete mDefaultSceneManager;
 
@@ -340,6 +391,7 @@ Belle::~Belle()
     }
 
     saveSettings();
+    UndoHistory::destroy();
 }
 
 void Belle::onEditResource(GameObject* obj)
@@ -780,7 +832,12 @@ void Belle::showBuiltinBrowserMessage()
 
 void Belle::onRunTriggered()
 {
-    if (! checkEnginePath())
+    //the export that's running uses the project's assets until it finishes
+    if (mExporting || ! checkEnginePath())
+        return;
+
+    //a preview that's already running gets the changes without reloading
+    if (updatePreview())
         return;
 
     QString exportedTo = exportProject(QDir::tempPath(), true);
@@ -794,6 +851,12 @@ void Belle::onRunTriggered()
             return;
         }
 
+        //external browsers reload the open preview instead of opening a new one
+        if (! Engine::useBuiltinBrowser() && mHttpServer.subscriberCount() > 0) {
+            mHttpServer.publish("reload", QByteArray());
+            return;
+        }
+
         if (!Engine::useBuiltinBrowser() && mShowBuiltinBrowserMessage) {
             showBuiltinBrowserMessage();
         }
@@ -814,6 +877,9 @@ void Belle::onRunTriggered()
 
 QString Belle::exportProject(const QString& _path, bool toRun)
 {
+    if (mExporting)
+        return "";
+
     if (! Engine::isValid()) {
         QMessageBox::critical(this, tr("Invalid engine directory"), tr("Please, first set a valid engine directory through the menu Project > Properties"));
         return "";
@@ -825,8 +891,7 @@ QString Belle::exportProject(const QString& _path, bool toRun)
     if (path.isEmpty())
         return "";
 
-    QString fileName(GAME_FILENAME);
-    QDir engineDir (Engine::path());
+    TraceSpan span(toRun ? "export preview" : "export project", "export", path);
     QString title = mNovelData.value("title").toString();
     QDir projectDir(path);
 
@@ -844,25 +909,115 @@ QString Belle::exportProject(const QString& _path, bool toRun)
         projectDir = QDir(mCurrentRunDirectory);
     }
 
-    //copy all engine files
-    QStringList fileNames = engineDir.entryList(QStringList() << "*.js" << "*.html" << "*.css", QDir::Files | QDir::NoSymLinks | QDir::NoDotAndDotDot);
-    bool pathChanged = Engine::pathChanged();
-    foreach(const QString&fileName, fileNames) {
-        if (pathChanged && QFile::exists(projectDir.absoluteFilePath(fileName)))
-            QFile::remove(projectDir.absoluteFilePath(fileName));
-        QFile::copy(engineDir.absoluteFilePath(fileName), projectDir.absoluteFilePath(fileName));
+    //assets are exported in the background while the event loop keeps running, so the modal
+    //dialog is shown right away to keep the project from being edited until the export is done
+    ExportProgress progress;
+    QProgressDialog progressDialog(tr("Exporting..."), tr("Cancel"), 0, 0, this);
+    progressDialog.setWindowModality(Qt::WindowModal);
+    progressDialog.setAutoReset(false);
+    progressDialog.setAutoClose(false);
+    progressDialog.setMinimumDuration(0);
+    connect(&progress, SIGNAL(maximumChanged(int)), &progressDialog, SLOT(setMaximum(int)));
+    connect(&progress, SIGNAL(valueChanged(int)), &progressDialog, SLOT(setValue(int)));
+    connect(&progressDialog, SIGNAL(canceled()), &progress, SLOT(cancel()));
+    //canceling hides the dialog, but the running jobs still have to finish
+    connect(&progressDialog, SIGNAL(canceled()), &progressDialog, SLOT(show()));
+    progressDialog.show();
+
+    QVariantMap gameData = createGameFile();
+    if (toRun)
+        gameData.insert("livePreview", true);
+
+    Exporter exporter(gameData);
+    exporter.setProgress(&progress);
+    //previews export the whole project, stripping is only worth it for real exports
+    exporter.setStripUnused(! toRun);
+    //and so is optimizing the assets, which would otherwise be redone on every run
+    exporter.setOptimizeAssets(! toRun);
+    //off by default, the preview server sends the gzipped copies too when there are any
+    exporter.setCompress(mNovelData.value("compressExport", false).toBool());
+    mExporting = true;
+    bool exported = exporter.exportTo(projectDir, Engine::pathChanged());
+    mExporting = false;
+    progressDialog.close();
+
+    foreach(const QString& timing, progress.timings())
+        qDebug() << "Export stage" << qPrintable(timing);
+
+    if (! exported) {
+        if (! progress.isCanceled())
+            QMessageBox::critical(this, tr("Export failed"), exporter.errorString());
+        return "";
+    }
+
+    if (toRun) {
+        mPreviewGameData = gameData;
+        mPreviewAssets = assetNames();
     }
 
-    //copy images, sounds and fonts in use
-    AssetManager::instance()->save(projectDir);
+    QStringList stripped = exporter.strippedItems();
+    if (! stripped.isEmpty()) {
+        QMessageBox messageBox(QMessageBox::Information, tr("Export finished"),
+                               tr("%1 unused items were left out of the export.").arg(stripped.size()), QMessageBox::Ok, this);
+        messageBox.setDetailedText(stripped.join("\n"));
+        messageBox.exec();
+    }
 
-    //export gameFile
-    exportGameFile(projectDir.absoluteFilePath(fileName));
+    QStringList conditionErrors = exporter.conditionErrors();
+    if (! toRun && ! conditionErrors.isEmpty()) {
+        QMessageBox messageBox(QMessageBox::Warning, tr("Invalid conditions"),
+                               tr("%1 branch conditions have errors and may not work as expected.").arg(conditionErrors.size()), QMessageBox::Ok, this);
+        messageBox.setDetailedText(conditionErrors.join("\n"));
+        messageBox.exec();
+    }
 
     return projectDir.absolutePath();
     //Utils::safeCopy(QDir::current().absoluteFilePath(fileName), projectDir.absoluteFilePath(fileName));
 }
 
+//Sends what changed since the last run to the open preview, which patches its scenes in place.
+//New or removed assets need a full export, so false is returned then.
+bool Belle::updatePreview()
+{
+    if (mExporting || mCurrentRunDirectory.isEmpty() || mPreviewGameData.isEmpty() || mHttpServer.subscriberCount() == 0)
+        return false;
+    if (Engine::useBuiltinBrowser() && ! mWebViewWindow->isVisible())
+        return false;
+
+    QStringList assets = assetNames();
+    if (assets != mPreviewAssets)
+        return false;
+
+    QVariantMap gameData = createGameFile();
+    gameData.insert("livePreview", true);
+    QVariantMap delta = GameDataDelta::diff(mPreviewGameData, gameData, assets);
+
+    //refreshing the page has to show the changes too
+    QString gameFile = QDir(mCurrentRunDirectory).absoluteFilePath(GAME_FILENAME);
+    if (! Exporter::writeGameFile(gameData, gameFile))
+        return false;
+    if (mNovelData.value("compressExport", false).toBool())
+        GzipWriter::compressFile(gameFile);
+    mHttpServer.cache()->clear();
+    mPreviewGameData = gameData;
+
+    if (delta.contains("reload"))
+        mHttpServer.publish("reload", QByteArray());
+    else if (! delta.isEmpty())
+        mHttpServer.publish("update", QJsonDocument::fromVariant(delta).toJson(QJsonDocument::Compact));
+
+    return true;
+}
+
+QStringList Belle::assetNames() const
+{
+    QStringList names;
+    foreach(Asset* asset, AssetManager::instance()->assets())
+        names.append(asset->name());
+    names.sort();
+    return names;
+}
+
 bool Belle::saveProject()
 {
     if (mSavePath.isEmpty() || ! QFile::exists(mSavePath)) {
@@ -879,11 +1034,15 @@ bool Belle::saveProject()
     }
 
     if (QFile::exists(mSavePath)) {
+        TraceSpan span("save project", "project", mSavePath);
         QDir projectDir(mSavePath);
         //copy images and fonts in use
         AssetManager::instance()->save(projectDir, true);
         //export gameFile
-        exportGameFile(projectDir.absoluteFilePath(GAME_FILENAME));
+        QVariantMap gameData = createGameFile();
+        Exporter::writeGameFile(gameData, projectDir.absoluteFilePath(GAME_FILENAME));
+        discardAutoSave();
+        mAutoSaver->setBaseline(gameData, AutoSaver::autosavePath(mSavePath));
 
         if(statusBar())
             statusBar()->showMessage(tr("Project saved..."), 3000);
@@ -896,40 +1055,24 @@ bool Belle::saveProject()
 
 QVariantMap Belle::readGameFile(const QString& filepath) const
 {
-    QVariantMap dataMap;
-
-    QFile file(filepath);
-    if (! file.open(QFile::ReadOnly))
-        return dataMap;
-
-    QByteArray contents = file.readAll();
-    file.close();
-
-    //if new game file format, just remove start ("game.data =")
-    int i = 0;
-    for(i=0; i < contents.size() && contents[i] != '{'; i++);
-    contents = contents.mid(i);
-
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(contents, &error);
-    if (error.error != QJsonParseError::NoError)
-        return dataMap;
-
-    QVariant data = doc.toVariant();
-    if (data.type() != QVariant::Map)
-        return dataMap;
-
-    return data.toMap();
+    return Exporter::readGameFile(filepath);
 }
 
 void Belle::clearProject()
 {
+    bool recordingBlocked = UndoHistory::blockRecording(true);
     mDefaultSceneManager->removeScenes(true);
     mPauseSceneManager->removeScenes(true);
     ResourceManager::instance()->clear(true);
+    UndoHistory::blockRecording(recordingBlocked);
+    UndoHistory::instance()->clear();
     AssetManager::instance()->clear();
+    //the changes were either saved or dropped by the user
+    discardAutoSave();
     mSavePath = "";
     mCurrentRunDirectory = "";
+    mPreviewGameData.clear();
+    mPreviewAssets.clear();
 }
 
 void Belle::openFileOrProject(QString filepath)
@@ -946,7 +1089,19 @@ void Belle::openFileOrProject(QString filepath)
     if (filepath.isEmpty())
         return;
 
-    QVariantMap object = readGameFile(filepath);
+    TraceSpan span("open project", "project", filepath);
+    bool recovered = false;
+    //a newer autosave is left behind when the editor closes without saving
+    QFileInfo autosaveInfo(AutoSaver::autosavePath(QFileInfo(filepath).absolutePath()));
+    if (autosaveInfo.exists() && autosaveInfo.lastModified() > QFileInfo(filepath).lastModified()) {
+        QMessageBox::StandardButton reply;
+        reply = QMessageBox::question(this, tr("Recover autosave?"),
+                                      tr("This project has unsaved changes from a previous session.\nDo you want to recover them?"),
+                                      QMessageBox::Yes|QMessageBox::No, QMessageBox::Yes);
+        recovered = (reply == QMessageBox::Yes);
+    }
+
+    QVariantMap object = readGameFile(recovered ? autosaveInfo.absoluteFilePath() : filepath);
 
     if (object.isEmpty()) {
         QMessageBox::warning(this, tr("ERROR"),
@@ -954,7 +1109,10 @@ void Belle::openFileOrProject(QString filepath)
         return;
     }
 
+    //files added after the last save were never copied into the project
+    QStringList unsavedAssets = object.take(AUTOSAVE_ASSETS_KEY).toStringList();
     clearProject();
+    bool recordingBlocked = UndoHistory::blockRecording(true);
     mSavePath = QFileInfo(filepath).absolutePath();
     saveDir = QFileInfo(filepath).absoluteDir();
     AssetManager::instance()->setLoadPath(mSavePath);
@@ -1010,6 +1168,16 @@ void Belle::openFileOrProject(QString filepath)
         }
     }
 
+    UndoHistory::blockRecording(recordingBlocked);
+    mAutoSaver->setBaseline(recovered ? readGameFile(filepath) : object, AutoSaver::autosavePath(mSavePath));
+
+    if (! unsavedAssets.isEmpty()) {
+        QMessageBox::warning(this,
+                             tr("Recovered project warning"),
+                             tr("These files were added after the project was last saved and are not part of it. "
+                                "If they were moved or deleted, they have to be added again:\n%1").arg(unsavedAssets.join("\n")));
+    }
+
     emit projectLoaded();
 }
 
@@ -1027,18 +1195,24 @@ void Belle::_fixSync(const QList<Scene*>& scenes)
 
 void Belle::importScenes(const QVariantList& scenes, SceneManager* sceneManager)
 {
+    TraceSpan span("import scenes", "project");
     Scene *scene = 0;
 
+    //scenes are only added as stubs, they get loaded once they become the current scene
     for(int i=0; i < scenes.size(); i++) {
         if (scenes[i].type() == QVariant::Map) {
-            scene = new Scene(scenes[i].toMap(), sceneManager);
-            addScene(scene, sceneManager);
+            scene = new Scene(scenes[i].toMap(), sceneManager, true);
+            sceneManager->addScene(scene);
+            createSceneTreeItem(scenesWidget(sceneManager), scene, false);
         }
     }
+
+    mDrawingSurfaceWidget->setSceneManager(sceneManager);
 }
 
 QVariantMap Belle::createGameFile() const
 {
+    TraceSpan span("create game file", "project");
     QVariantMap jsonFile;
     QMapIterator<QString, QVariant> it(mNovelData);
 
@@ -1100,16 +1274,7 @@ void Belle::exportGameFile(const QString& path)
         filepath = QDir(dirpath).absoluteFilePath(GAME_FILENAME);
     }
 
-    QFile file(filepath);
-
-    if (! file.open(QFile::WriteOnly))
-        return;
-
-    QVariantMap jsonFile = createGameFile();
-
-    file.write("game.data = ");
-    file.write(QJsonDocument::fromVariant(jsonFile).toJson(QJsonDocument::Compact));
-    file.close();
+    Exporter::writeGameFile(createGameFile(), filepath);
 }
 
 void Belle::showAboutDialog()
@@ -1350,6 +1515,18 @@ void Belle::setNovelProperties(const QVariantMap& _data)
         mNovelData.insert("textSpeed", data.value("textSpeed").toInt());
     }
 
+    if (data.contains("imageQuality") && data.value("imageQuality").canConvert(QVariant::Int)) {
+        mNovelData.insert("imageQuality", qBound(0, data.value("imageQuality").toInt(), 100));
+    }
+
+    if (data.contains("imageFormat") && data.value("imageFormat").type() == QVariant::String) {
+        mNovelData.insert("imageFormat", data.value("imageFormat").toString());
+    }
+
+    if (data.contains("compressExport") && data.value("compressExport").type() == QVariant::Bool) {
+        mNovelData.insert("compressExport", data.value("compressExport").toBool());
+    }
+
     //Font string is deprecated. Remove at some point.
     if (data.contains("font") && data.value("font").type() == QVariant::String) {
         int fontSize = Utils::fontSize(data.value("font").toString());
@@ -1460,12 +1637,98 @@ bool Belle::confirmQuit(const QString& title, const QString& text)
     return true;
 }
 
+//the snapshot is cheap to take, encoding and writing it happens on the thread pool
+void Belle::autoSave()
+{
+    //projects that were never saved have nowhere to autosave to
+    if (mSavePath.isEmpty() || ! QFile::exists(mSavePath))
+        return;
+
+    QVariantMap gameData;
+    {
+        TraceSpan span("autosave snapshot", "project");
+        gameData = createGameFile();
+    }
+
+    //the game data only has the names of the assets, which are resolved inside the project
+    QStringList unsavedAssets;
+    foreach(Asset* asset, AssetManager::instance()->assets()) {
+        if (! asset->isRemovable() && ! asset->path().isEmpty())
+            unsavedAssets.append(asset->path());
+    }
+    if (! unsavedAssets.isEmpty())
+        gameData.insert(AUTOSAVE_ASSETS_KEY, unsavedAssets);
+
+    mAutoSaver->save(gameData, AutoSaver::autosavePath(mSavePath));
+}
+
+void Belle::onAutoSaved(const QString&)
+{
+    if (statusBar())
+        statusBar()->showMessage(tr("Project autosaved..."), 2000);
+}
+
+void Belle::onAutoSaveFailed(const QString& path)
+{
+    if (statusBar())
+        statusBar()->showMessage(tr("Couldn't autosave to %1").arg(path), 5000);
+}
+
+void Belle::discardAutoSave()
+{
+    if (! mSavePath.isEmpty())
+        mAutoSaver->discard(AutoSaver::autosavePath(mSavePath));
+}
+
+//undo and redo can add, remove and move scenes, objects and actions
+void Belle::onUndoHistoryApplied()
+{
+    updateScenesWidget(scenesWidget(mDefaultSceneManager), mDefaultSceneManager->currentSceneIndex(), mCurrentSceneManager == mDefaultSceneManager);
+    updateScenesWidget(scenesWidget(mPauseSceneManager), mPauseSceneManager->currentSceneIndex(), mCurrentSceneManager == mPauseSceneManager);
+
+    int index = mCurrentSceneManager->currentSceneIndex();
+    if (index < 0 || index >= mCurrentSceneManager->size())
+        index = 0;
+    setCurrentSceneIndex(index);
+}
+
+//Starts recording a new trace; when stopped, the trace is saved for chrome://tracing
+void Belle::onRecordTraceToggled(bool record)
+{
+    if (record) {
+        Tracer::clear();
+        Tracer::setEnabled(true);
+        statusBar()->showMessage(tr("Recording performance trace..."), 3000);
+        return;
+    }
+
+    Tracer::setEnabled(false);
+    if (Tracer::eventCount() == 0)
+        return;
+
+    QString path = QFileDialog::getSaveFileName(this, tr("Save Performance Trace"), QDir::home().absoluteFilePath("belle-trace.json"),
+                                                tr("Chrome Trace") + " (*.json)");
+    if (path.isEmpty())
+        return;
+
+    if (! Tracer::save(path))
+        QMessageBox::critical(this, tr("Couldn't save the trace"), tr("Couldn't write the trace to %1").arg(path));
+    Tracer::clear();
+}
+
 void Belle::closeEvent(QCloseEvent *event)
 {
+    if (mExporting) {
+        event->ignore();
+        return;
+    }
+
     bool confirmed = confirmQuit(tr("Quit?"), tr("You have unsaved changes.\nDo you want to save changes before closing?"));
 
     if(! confirmed)
         event->ignore();
+    else
+        discardAutoSave();
 }
 
 bool Belle::loadDefaultGame()
@@ -1498,13 +1761,17 @@ void Belle::loadEmptyProject()
     data.insert("width", WIDTH);
     data.insert("height", HEIGHT);
     data.insert("textSpeed", 50);
+    data.insert("imageQuality", 85);
+    data.insert("imageFormat", "jpg");
     data.insert("fontSize", 18);
     data.insert("fontFamily", "Arial");
     setNovelProperties(data);
 
+    bool recordingBlocked = UndoHistory::blockRecording(true);
     bool loaded = loadDefaultGame();
     if (! loaded)
         addScene();
+    UndoHistory::blockRecording(recordingBlocked);
 }
 
 Clipboard* Belle::clipboard() const
@@ -21,6 +21,7 @@
 #include <QVariant>
 #include <QSettings>
 #include <QWebView>
+#include <QTimer>
 
 #include "scene_manager.h"
 #include "ui_mainwindow.h"
@@ -31,10 +32,11 @@
 #include "resources_view.h"
 #include "simple_http_server.h"
 #include "webviewwindow.h"
+#include "exporter.h"
+#include "autosaver.h"
 
 #define WIDTH 640
 #define HEIGHT 480
-#define GAME_FILENAME "game_data.js"
 #define VERSION_STR "0.7b"
 #define VERSION 0x000700
 
@@ -50,6 +52,8 @@ class Belle : public QMainWindow
     bool mDisableClick;
     QVariantMap mNovelData;
     QString mCurrentRunDirectory;
+    QVariantMap mPreviewGameData;
+    QStringList mPreviewAssets;
     QList <QIcon> mIcons;
     QSettings *mSettings;
     SimpleHttpServer mHttpServer;
@@ -60,6 +64,9 @@ class Belle : public QMainWindow
     Clipboard* mClipboard;
     WebViewWindow* mWebViewWindow;
     bool mShowBuiltinBrowserMessage;
+    AutoSaver* mAutoSaver;
+    QTimer* mAutoSaveTimer;
+    bool mExporting;
     
     public:
         explicit Belle(QWidget *widget=0);
@@ -107,6 +114,11 @@ class Belle : public QMainWindow
         bool saveProject();
         void newProject();
         void scenesTabWidgetPageChanged(int);
+        void onRecordTraceToggled(bool);
+        void onUndoHistoryApplied();
+        void autoSave();
+        void onAutoSaved(const QString&);
+        void onAutoSaveFailed(const QString&);
 
 protected:
         virtual void closeEvent(QCloseEvent*);
@@ -148,6 +160,9 @@ private:
         void setCurrentSceneManager(SceneManager*);
         void showBuiltinBrowserMessage();
         void loadEmptyProject();
+        bool updatePreview();
+        void discardAutoSave();
+        QStringList assetNames() const;
 };
 
 #endif
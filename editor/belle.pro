@@ -10,7 +10,7 @@ DEPENDPATH += actions objects widgets conditions assets dialogs
 TARGET = belle
 TARGET.path = $$PREFIX/
 CONFIG+=debug
-QT += core network webkitwidgets
+QT += core network webkitwidgets concurrent
 
 FORMS += mainwindow.ui\
     novel_properties_dialog.ui \
@@ -117,7 +117,9 @@ HEADERS      += belle.h\
     editorwidgetfactory.h \
     gameobjectmanager.h \
     webviewwindow.h \
-    sockettimeout.h \
+    httpconnection.h \
+    httprequestparser.h \
+    filecache.h \
     gameobjectmetatype.h \
     gameobjectfactory.h \
     conditions/conditiontoken.h \
@@ -129,6 +131,7 @@ HEADERS      += belle.h\
     conditions/conditiontokenfactory.h \
     conditions/conditiontokenmetatype.h \
     conditions/conditionlogicaloperator.h \
+    conditions/conditioncompiler.h \
     actions/set_game_variable.h \
     actions/set_game_variable_editor_widget.h \
     widgets/variablevalidator.h \
@@ -150,7 +153,18 @@ HEADERS      += belle.h\
     actions/actionmetatype.h \
     dialogs/actionmanagerdialog.h \
     widgets/actionmanagerbutton.h \
-    actionpool.h
+    actionpool.h \
+    exporter.h \
+    atlaspacker.h \
+    dependencyanalyzer.h \
+    fontsubsetter.h \
+    exportprogress.h \
+    gzipwriter.h \
+    gamedatadelta.h \
+    tracer.h \
+    paintstatistics.h \
+    undohistory.h \
+    autosaver.h
                 
 
 SOURCES      += main.cpp\
@@ -250,7 +264,9 @@ SOURCES      += main.cpp\
     editorwidgetfactory.cpp \
     gameobjectmanager.cpp \
     webviewwindow.cpp \
-    sockettimeout.cpp \
+    httpconnection.cpp \
+    httprequestparser.cpp \
+    filecache.cpp \
     gameobjectmetatype.cpp \
     gameobjectfactory.cpp \
     conditions/conditiontoken.cpp \
@@ -261,6 +277,7 @@ SOURCES      += main.cpp\
     conditions/literalcondition.cpp \
     conditions/conditiontokenfactory.cpp \
     conditions/conditionlogicaloperator.cpp \
+    conditions/conditioncompiler.cpp \
     actions/set_game_variable.cpp \
     actions/set_game_variable_editor_widget.cpp \
     widgets/variablevalidator.cpp \
@@ -283,6 +300,17 @@ SOURCES      += main.cpp\
     actions/actionmetatype.cpp \
     dialogs/actionmanagerdialog.cpp \
     widgets/actionmanagerbutton.cpp \
-    actionpool.cpp
+    actionpool.cpp \
+    exporter.cpp \
+    atlaspacker.cpp \
+    dependencyanalyzer.cpp \
+    fontsubsetter.cpp \
+    exportprogress.cpp \
+    gzipwriter.cpp \
+    gamedatadelta.cpp \
+    tracer.cpp \
+    paintstatistics.cpp \
+    undohistory.cpp \
+    autosaver.cpp
 
 RESOURCES += media.qrc
@@ -0,0 +1,128 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "engine.h"
+#include "exporter.h"
+#include "exportprogress.h"
+#include "assetmanager.h"
+#include "fontlibrary.h"
+#include "tracer.h"
+
+enum ExitCode {
+    ExitOk = 0,
+    ExitUsage = 1,
+    ExitLoadFailed = 2,
+    ExitInvalidProject = 3,
+    ExitExportFailed = 4
+};
+
+int main(int argc, char ** argv)
+{
+    //pixmaps and fonts still need a gui application, but not a display
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setApplicationName("belle-cli");
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Validates a Belle project and exports it for the web.");
+    parser.addHelpOption();
+    QCommandLineOption engineOption(QStringList() << "e" << "engine", "Engine directory.", "directory");
+    QCommandLineOption validateOption(QStringList() << "n" << "validate-only", "Only validate the project.");
+    QCommandLineOption keepUnusedOption(QStringList() << "k" << "keep-unused", "Export unreachable scenes and unused resources and assets.");
+    parser.addOption(engineOption);
+    parser.addOption(validateOption);
+    QCommandLineOption gzipOption(QStringList() << "z" << "gzip", "Write gzipped copies of the game data, scripts and styles.");
+    parser.addOption(keepUnusedOption);
+    parser.addOption(gzipOption);
+    parser.addPositionalArgument("project", "Project directory or game file.");
+    parser.addPositionalArgument("output", "Directory to export the game to.");
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    bool validateOnly = parser.isSet(validateOption);
+    if (args.isEmpty() || (! validateOnly && args.size() < 2)) {
+        err << parser.helpText();
+        return ExitUsage;
+    }
+
+    if (parser.isSet(engineOption))
+        Engine::setPath(parser.value(engineOption));
+    else
+        Engine::loadPath();
+
+    if (! validateOnly && ! Engine::isValid()) {
+        err << "Invalid engine directory: " << Engine::path() << endl;
+        return ExitUsage;
+    }
+
+    QFileInfo projectInfo(args.at(0));
+    QString gameFile = projectInfo.isDir() ? QDir(projectInfo.absoluteFilePath()).absoluteFilePath(GAME_FILENAME) : projectInfo.absoluteFilePath();
+    QString projectPath = QFileInfo(gameFile).absolutePath();
+    QElapsedTimer timer;
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    //load
+    Tracer::init();
+    timer.start();
+    FontLibrary::init();
+    QVariantMap gameData = Exporter::readGameFile(gameFile);
+    if (gameData.isEmpty()) {
+        err << "Couldn't read the game file: " << gameFile << endl;
+        return ExitLoadFailed;
+    }
+    AssetManager::instance()->setLoadPath(projectPath);
+    AssetManager::instance()->load(QDir(projectPath));
+    out << "load: " << timer.elapsed() << " ms" << endl;
+
+    //validate
+    timer.restart();
+    Exporter exporter(gameData);
+    QStringList errors = exporter.validate();
+    out << "validate: " << timer.elapsed() << " ms" << endl;
+    if (! errors.isEmpty()) {
+        foreach(const QString& error, errors)
+            err << "error: " << error << endl;
+        return ExitInvalidProject;
+    }
+
+    if (validateOnly)
+        return ExitOk;
+
+    //export
+    timer.restart();
+    QDir outputDir(args.at(1));
+    if (! outputDir.exists() && ! QDir().mkpath(outputDir.absolutePath())) {
+        err << "Couldn't create the output directory: " << outputDir.absolutePath() << endl;
+        return ExitExportFailed;
+    }
+
+    ExportProgress progress;
+    exporter.setProgress(&progress);
+    exporter.setStripUnused(! parser.isSet(keepUnusedOption));
+    exporter.setCompress(parser.isSet(gzipOption));
+    if (! exporter.exportTo(outputDir, true)) {
+        err << exporter.errorString() << endl;
+        return ExitExportFailed;
+    }
+    out << "export: " << timer.elapsed() << " ms" << endl;
+    foreach(const QString& stage, progress.timings())
+        out << "  " << stage << endl;
+    foreach(const QString& item, exporter.strippedItems())
+        out << "stripped: " << item << endl;
+    foreach(const QString& error, exporter.conditionErrors())
+        err << "warning: " << error << endl;
+    out << "total: " << totalTimer.elapsed() << " ms" << endl;
+    if (Tracer::isEnabled() && Tracer::save(QString::fromLocal8Bit(qgetenv(TRACE_ENV_VARIABLE))))
+        out << "trace: " << QString::fromLocal8Bit(qgetenv(TRACE_ENV_VARIABLE)) << endl;
+
+    AssetManager::destroy();
+    return ExitOk;
+}
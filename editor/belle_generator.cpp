@@ -0,0 +1,108 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include "projectgenerator.h"
+#include "gameobjectfactory.h"
+#include "assetmanager.h"
+#include "resource_manager.h"
+#include "fontlibrary.h"
+
+enum ExitCode {
+    ExitOk = 0,
+    ExitUsage = 1,
+    ExitGenerateFailed = 2
+};
+
+static bool intOption(const QCommandLineParser& parser, const QCommandLineOption& option, int& value)
+{
+    if (! parser.isSet(option))
+        return true;
+
+    bool ok = false;
+    int result = parser.value(option).toInt(&ok);
+    if (! ok || result < 0)
+        return false;
+    value = result;
+    return true;
+}
+
+int main(int argc, char ** argv)
+{
+    //pixmaps and fonts still need a gui application, but not a display
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setApplicationName("belle-generator");
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates a Belle project with the given number of scenes, objects, actions and assets.");
+    parser.addHelpOption();
+    QCommandLineOption scenesOption(QStringList() << "s" << "scenes", "Number of scenes (10).", "count");
+    QCommandLineOption objectsOption(QStringList() << "o" << "objects", "Objects per scene (10).", "count");
+    QCommandLineOption actionsOption(QStringList() << "a" << "actions", "Actions per scene (20).", "count");
+    QCommandLineOption resourcesOption(QStringList() << "r" << "resources", "Number of resources (5).", "count");
+    QCommandLineOption clonesOption(QStringList() << "c" << "clones", "Clones per resource (2).", "count");
+    QCommandLineOption depthOption(QStringList() << "d" << "group-depth", "Nesting depth of object groups (1).", "depth");
+    QCommandLineOption labelsOption(QStringList() << "l" << "label-density", "Percentage of actions that are labels (10).", "percent");
+    QCommandLineOption imagesOption(QStringList() << "i" << "images", "Number of generated images (10).", "count");
+    QCommandLineOption imageSizeOption("image-size", "Width and height of the generated images (256).", "pixels");
+    QCommandLineOption seedOption("seed", "Random seed, the same seed gives the same project (1).", "seed");
+    parser.addOption(scenesOption);
+    parser.addOption(objectsOption);
+    parser.addOption(actionsOption);
+    parser.addOption(resourcesOption);
+    parser.addOption(clonesOption);
+    parser.addOption(depthOption);
+    parser.addOption(labelsOption);
+    parser.addOption(imagesOption);
+    parser.addOption(imageSizeOption);
+    parser.addOption(seedOption);
+    parser.addPositionalArgument("output", "Directory to write the project to.");
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    if (args.isEmpty()) {
+        err << parser.helpText();
+        return ExitUsage;
+    }
+
+    ProjectGeneratorOptions options;
+    int imageSize = options.imageSize.width();
+    int seed = options.seed;
+    if (! intOption(parser, scenesOption, options.scenes) ||
+        ! intOption(parser, objectsOption, options.objectsPerScene) ||
+        ! intOption(parser, actionsOption, options.actionsPerScene) ||
+        ! intOption(parser, resourcesOption, options.resources) ||
+        ! intOption(parser, clonesOption, options.clonesPerResource) ||
+        ! intOption(parser, depthOption, options.groupDepth) ||
+        ! intOption(parser, labelsOption, options.labelDensity) ||
+        ! intOption(parser, imagesOption, options.images) ||
+        ! intOption(parser, imageSizeOption, imageSize) ||
+        ! intOption(parser, seedOption, seed) || imageSize == 0) {
+        err << "Counts, sizes and the seed must be positive numbers." << endl;
+        return ExitUsage;
+    }
+    options.imageSize = QSize(imageSize, imageSize);
+    options.seed = seed;
+
+    GameObjectFactory::init();
+    FontLibrary::init();
+
+    QElapsedTimer timer;
+    timer.start();
+    ProjectGenerator generator(options);
+    if (! generator.generate(QDir(args.at(0)))) {
+        err << generator.errorString() << endl;
+        return ExitGenerateFailed;
+    }
+    out << "generated " << options.scenes << " scenes in " << timer.elapsed() << " ms: " << QDir(args.at(0)).absolutePath() << endl;
+
+    AssetManager::destroy();
+    ResourceManager::destroy();
+    return ExitOk;
+}
@@ -0,0 +1,221 @@
+#include "conditioncompiler.h"
+
+#include <QObject>
+
+#include "conditiontokenmetatype.h"
+#include "conditionlogicaloperator.h"
+#include "variablevalidator.h"
+
+ConditionCompiler::ConditionCompiler()
+{
+}
+
+ConditionCompiler::~ConditionCompiler()
+{
+}
+
+QStringList ConditionCompiler::errors() const
+{
+    return mErrors;
+}
+
+//Returns false when the condition can't be compiled; errors() is empty if it's only because it's a literal condition
+bool ConditionCompiler::compile(const QVariant& condition, QString* expression)
+{
+    mErrors.clear();
+    if (condition.type() != QVariant::Map) {
+        mErrors << QObject::tr("The condition is not in a valid format.");
+        return false;
+    }
+
+    return compileCondition(condition.toMap(), expression);
+}
+
+bool ConditionCompiler::compileCondition(const QVariantMap& data, QString* expression)
+{
+    switch(data.value("type").toInt()) {
+    case ConditionTokenMetaType::SimpleCondition:
+        return compileSimple(data.value("value").toMap(), expression);
+    case ConditionTokenMetaType::ComplexCondition:
+        return compileComplex(data.value("value").toList(), expression);
+    case ConditionTokenMetaType::LiteralCondition:
+        return false;
+    default:
+        mErrors << QObject::tr("Unknown condition type: %1").arg(data.value("type").toInt());
+        return false;
+    }
+}
+
+bool ConditionCompiler::compileSimple(const QVariantMap& data, QString* expression)
+{
+    ConditionOperation::Type operation = (ConditionOperation::Type) data.value("operation").toInt();
+    QVariantMap leftData = data.value("leftOperand").toMap();
+    QVariantMap rightData = data.value("rightOperand").toMap();
+    bool unary = operation == ConditionOperation::IsTrue || operation == ConditionOperation::IsFalse ||
+                 operation == ConditionOperation::IsDefined || operation == ConditionOperation::IsUndefined;
+    bool numeric = operation == ConditionOperation::GreaterThan || operation == ConditionOperation::GreaterThanOrEqual ||
+                   operation == ConditionOperation::LesserThan || operation == ConditionOperation::LesserThanOrEqual;
+    int leftType = leftData.value("type").toInt();
+
+    QString left, right;
+    if (! compileOperand(leftData, &left))
+        return false;
+    if (! unary && ! compileOperand(rightData, &right))
+        return false;
+
+    if (numeric && (! isNumeric(leftData) || ! isNumeric(rightData))) {
+        mErrors << QObject::tr("Only numbers can be compared with \"%1\".").arg(ConditionOperation::toString(operation));
+        return false;
+    }
+
+    if (operation == ConditionOperation::Contains && (leftType == ConditionTokenMetaType::Number || leftType == ConditionTokenMetaType::Boolean)) {
+        mErrors << QObject::tr("Only text and lists can contain other values.");
+        return false;
+    }
+
+    if ((operation == ConditionOperation::IsDefined || operation == ConditionOperation::IsUndefined) && leftType != ConditionTokenMetaType::Variable) {
+        mErrors << QObject::tr("Only variables can be checked with \"%1\".").arg(ConditionOperation::toString(operation));
+        return false;
+    }
+
+    switch(operation) {
+    case ConditionOperation::Equal: *expression = left + " == " + right; break;
+    case ConditionOperation::NotEqual: *expression = left + " != " + right; break;
+    case ConditionOperation::Contains: *expression = left + ".indexOf(" + right + ") != -1"; break;
+    case ConditionOperation::GreaterThan: *expression = "Number(" + left + ") > Number(" + right + ")"; break;
+    case ConditionOperation::GreaterThanOrEqual: *expression = "Number(" + left + ") >= Number(" + right + ")"; break;
+    case ConditionOperation::LesserThan: *expression = "Number(" + left + ") < Number(" + right + ")"; break;
+    case ConditionOperation::LesserThanOrEqual: *expression = "Number(" + left + ") <= Number(" + right + ")"; break;
+    case ConditionOperation::IsTrue: *expression = "!!" + left; break;
+    case ConditionOperation::IsFalse: *expression = "!" + left; break;
+    case ConditionOperation::IsDefined: *expression = left + " !== undefined"; break;
+    case ConditionOperation::IsUndefined: *expression = left + " === undefined"; break;
+    default:
+        mErrors << QObject::tr("The condition has no operation.");
+        return false;
+    }
+
+    *expression = "(" + *expression + ")";
+    return true;
+}
+
+//Conditions and operators alternate; runs joined by "and" are grouped first
+bool ConditionCompiler::compileComplex(const QVariantList& tokens, QString* expression)
+{
+    if (tokens.isEmpty()) {
+        *expression = "false";
+        return true;
+    }
+
+    QStringList orGroups;
+    QStringList andGroup;
+    bool expectCondition = true;
+
+    foreach(const QVariant& token, tokens) {
+        QVariantMap data = token.toMap();
+        int type = data.value("type").toInt();
+
+        if (type == ConditionTokenMetaType::LogicalOperator) {
+            if (expectCondition) {
+                mErrors << QObject::tr("A logical operator is missing a condition before it.");
+                return false;
+            }
+
+            if (data.value("value").toInt() == ConditionLogicalOperator::Or) {
+                orGroups << (andGroup.size() > 1 ? "(" + andGroup.join(" && ") + ")" : andGroup.first());
+                andGroup.clear();
+            }
+            expectCondition = true;
+            continue;
+        }
+
+        if (! expectCondition) {
+            mErrors << QObject::tr("Two conditions are missing a logical operator between them.");
+            return false;
+        }
+
+        QString condition;
+        if (! compileCondition(data, &condition))
+            return false;
+        andGroup << condition;
+        expectCondition = false;
+    }
+
+    if (expectCondition) {
+        mErrors << QObject::tr("A logical operator is missing a condition after it.");
+        return false;
+    }
+
+    orGroups << (andGroup.size() > 1 ? "(" + andGroup.join(" && ") + ")" : andGroup.first());
+    *expression = orGroups.size() > 1 ? "(" + orGroups.join(" || ") + ")" : orGroups.first();
+    return true;
+}
+
+bool ConditionCompiler::compileOperand(const QVariantMap& data, QString* operand)
+{
+    QString value = data.value("value").toString();
+
+    switch(data.value("type").toInt()) {
+    case ConditionTokenMetaType::Variable:
+        if (! VariableValidator::regularExpression().match(value).hasMatch()) {
+            mErrors << QObject::tr("\"%1\" is not a valid variable name.").arg(value);
+            return false;
+        }
+        //the engine's interpreter fails on variables that were never set, which makes the
+        //condition false; reading from null throws the same way inside the compiled function
+        *operand = "(" + quote(value) + " in v ? v[" + quote(value) + "] : null[" + quote(value) + "])";
+        return true;
+
+    case ConditionTokenMetaType::Value:
+        *operand = quote(value);
+        return true;
+
+    case ConditionTokenMetaType::Number: {
+        bool ok = false;
+        value.trimmed().toDouble(&ok);
+        if (! ok) {
+            mErrors << QObject::tr("\"%1\" is not a valid number.").arg(value);
+            return false;
+        }
+        *operand = value.trimmed();
+        return true;
+    }
+
+    case ConditionTokenMetaType::Boolean:
+        value = value.trimmed().toLower();
+        if (value != "true" && value != "false") {
+            mErrors << QObject::tr("\"%1\" is not true or false.").arg(value);
+            return false;
+        }
+        *operand = value;
+        return true;
+
+    default:
+        mErrors << QObject::tr("The condition is missing a value.");
+        return false;
+    }
+}
+
+//Variables are only known when the game runs, so they're assumed to hold numbers
+bool ConditionCompiler::isNumeric(const QVariantMap& data) const
+{
+    int type = data.value("type").toInt();
+    if (type == ConditionTokenMetaType::Variable || type == ConditionTokenMetaType::Number)
+        return true;
+
+    bool ok = false;
+    data.value("value").toString().trimmed().toDouble(&ok);
+    return type == ConditionTokenMetaType::Value && ok;
+}
+
+QString ConditionCompiler::quote(const QString& text) const
+{
+    QString quoted = text;
+    quoted.replace("\\", "\\\\");
+    quoted.replace("\"", "\\\"");
+    quoted.replace("\n", "\\n");
+    quoted.replace("\r", "\\r");
+    quoted.replace(QChar(0x2028), "\\u2028");
+    quoted.replace(QChar(0x2029), "\\u2029");
+    return "\"" + quoted + "\"";
+}
@@ -0,0 +1,33 @@
+#ifndef CONDITIONCOMPILER_H
+#define CONDITIONCOMPILER_H
+
+#include <QStringList>
+#include <QVariantMap>
+
+#include "conditionoperation.h"
+
+//Turns a serialized condition into a JavaScript expression over the game variables ("v"),
+//with "and" grouped before "or" so the engine only has to build a function from it once.
+//Literal conditions are free text, so they're left for the engine to interpret.
+//Using a variable that was never set makes the whole condition false, as when it's interpreted.
+class ConditionCompiler
+{
+    QStringList mErrors;
+
+public:
+    ConditionCompiler();
+    virtual ~ConditionCompiler();
+
+    bool compile(const QVariant&, QString* expression);
+    QStringList errors() const;
+
+private:
+    bool compileCondition(const QVariantMap&, QString*);
+    bool compileSimple(const QVariantMap&, QString*);
+    bool compileComplex(const QVariantList&, QString*);
+    bool compileOperand(const QVariantMap&, QString*);
+    bool isNumeric(const QVariantMap&) const;
+    QString quote(const QString&) const;
+};
+
+#endif // CONDITIONCOMPILER_H
@@ -0,0 +1,538 @@
+#include "dependencyanalyzer.h"
+
+#include <QRegExp>
+
+#include "gotoscene.h"
+#include "utils.h"
+
+DependencyAnalyzer::DependencyAnalyzer(const QVariantMap& gameData, const QStringList& assetNames)
+{
+    mGameData = gameData;
+    mResources = gameData.value("resources").toMap();
+    mGameSize = QSize(gameData.value("width").toInt(), gameData.value("height").toInt());
+    mAssetNames = assetNames.toSet();
+
+    QMapIterator<QString, QVariant> it(mResources);
+    while(it.hasNext()) {
+        it.next();
+        mResourceNames.insert(it.key());
+    }
+
+    it.toFront();
+    while(it.hasNext()) {
+        it.next();
+        mResourceDependencies.insert(it.key(), analyze(it.value().toMap(), false));
+    }
+
+    foreach(const QVariant& sceneData, gameData.value("scenes").toList()) {
+        QVariantMap scene = sceneData.toMap();
+        QString name = scene.value("name").toString();
+        mScenes.append(name);
+        mSceneDependencies.insert(name, analyze(scene));
+    }
+
+    foreach(const QVariant& sceneData, gameData.value("pauseScreen").toMap().value("scenes").toList()) {
+        QVariantMap scene = sceneData.toMap();
+        QString name = scene.value("name").toString();
+        mPauseScenes.append(name);
+        mPauseSceneDependencies.insert(name, analyze(scene));
+    }
+}
+
+DependencyAnalyzer::~DependencyAnalyzer()
+{
+}
+
+QStringList DependencyAnalyzer::scenes() const
+{
+    return mScenes;
+}
+
+//assets used by the scene, directly or through the resources it uses
+QStringList DependencyAnalyzer::sceneAssets(const QString& name) const
+{
+    if (! mSceneDependencies.contains(name))
+        return QStringList();
+
+    QStringList assets = assetsOf(mSceneDependencies.value(name)).toList();
+    assets.sort();
+    return assets;
+}
+
+QStringList DependencyAnalyzer::sceneResources(const QString& name) const
+{
+    if (! mSceneDependencies.contains(name))
+        return QStringList();
+
+    QStringList resources = resourcesClosure(mSceneDependencies.value(name).resources).toList();
+    resources.sort();
+    return resources;
+}
+
+//scenes that can be shown right after the given one
+QStringList DependencyAnalyzer::nextScenes(const QString& name) const
+{
+    int index = mScenes.indexOf(name);
+    if (index == -1)
+        return QStringList();
+
+    Dependencies deps = mSceneDependencies.value(name);
+    QSet<int> targets = deps.metaTargets;
+    QSet<QString> sceneNames = deps.sceneNames;
+
+    foreach(const QString& resource, resourcesClosure(deps.resources)) {
+        targets.unite(mResourceDependencies.value(resource).metaTargets);
+        sceneNames.unite(mResourceDependencies.value(resource).sceneNames);
+    }
+
+    QList<int> indexes;
+    if (deps.fallsThrough)
+        indexes.append(index + 1);
+
+    foreach(int target, targets) {
+        switch(target) {
+        case GoToScene::Next: indexes.append(index + 1); break;
+        case GoToScene::Previous: indexes.append(index - 1); break;
+        case GoToScene::First: indexes.append(0); break;
+        case GoToScene::Last: indexes.append(mScenes.size() - 1); break;
+        default: break;
+        }
+    }
+
+    foreach(const QString& sceneName, sceneNames) {
+        if (mScenes.contains(sceneName))
+            indexes.append(mScenes.indexOf(sceneName));
+    }
+
+    qSort(indexes);
+    QStringList next;
+    foreach(int i, indexes) {
+        if (i >= 0 && i < mScenes.size() && i != index && ! next.contains(mScenes.at(i)))
+            next.append(mScenes.at(i));
+    }
+
+    return next;
+}
+
+QStringList DependencyAnalyzer::pauseScreenAssets() const
+{
+    QSet<QString> assets;
+    foreach(const Dependencies& deps, mPauseSceneDependencies)
+        assets.unite(assetsOf(deps));
+
+    QStringList list = assets.toList();
+    list.sort();
+    return list;
+}
+
+QStringList DependencyAnalyzer::pauseScreenResources() const
+{
+    QSet<QString> resources;
+    foreach(const Dependencies& deps, mPauseSceneDependencies)
+        resources.unite(resourcesClosure(deps.resources));
+
+    QStringList list = resources.toList();
+    list.sort();
+    return list;
+}
+
+bool DependencyAnalyzer::hasScripts() const
+{
+    foreach(const Dependencies& deps, mSceneDependencies)
+        if (deps.hasScripts)
+            return true;
+    foreach(const Dependencies& deps, mPauseSceneDependencies)
+        if (deps.hasScripts)
+            return true;
+    foreach(const Dependencies& deps, mResourceDependencies)
+        if (deps.hasScripts)
+            return true;
+    return false;
+}
+
+//Scenes that can be reached from the first one or from the pause screen. Scripts can
+//jump anywhere, so if there are any, all scenes are considered reachable.
+QStringList DependencyAnalyzer::reachableScenes() const
+{
+    if (hasScripts() || mScenes.isEmpty())
+        return mScenes;
+
+    QSet<QString> reached;
+    QList<QString> pending;
+    pending.append(mScenes.first());
+    pending.append(pauseScreenTargets().toList());
+
+    while(! pending.isEmpty()) {
+        QString scene = pending.takeFirst();
+        if (reached.contains(scene))
+            continue;
+        reached.insert(scene);
+        pending.append(nextScenes(scene));
+    }
+
+    QStringList scenes;
+    foreach(const QString& scene, mScenes)
+        if (reached.contains(scene))
+            scenes.append(scene);
+    return scenes;
+}
+
+QStringList DependencyAnalyzer::usedResources() const
+{
+    if (hasScripts()) {
+        QStringList resources = mResourceNames.toList();
+        resources.sort();
+        return resources;
+    }
+
+    QSet<QString> resources = pauseScreenResources().toSet();
+    foreach(const QString& scene, reachableScenes())
+        resources.unite(sceneResources(scene).toSet());
+
+    QStringList list = resources.toList();
+    list.sort();
+    return list;
+}
+
+QStringList DependencyAnalyzer::usedAssets() const
+{
+    if (hasScripts()) {
+        QStringList assets = mAssetNames.toList();
+        assets.sort();
+        return assets;
+    }
+
+    QSet<QString> assets = pauseScreenAssets().toSet();
+    foreach(const QString& scene, reachableScenes())
+        assets.unite(sceneAssets(scene).toSet());
+
+    QStringList list = assets.toList();
+    list.sort();
+    return list;
+}
+
+//Assets needed by each scene, the scenes that can follow each one and the assets
+//needed before the game starts (first scene and pause screen).
+QVariantMap DependencyAnalyzer::manifests() const
+{
+    QVariantMap data;
+    QVariantMap sceneAssets;
+    QVariantMap next;
+
+    foreach(const QString& scene, mScenes) {
+        sceneAssets.insert(scene, this->sceneAssets(scene));
+        next.insert(scene, nextScenes(scene));
+    }
+
+    QStringList preload = pauseScreenAssets();
+    if (! mScenes.isEmpty()) {
+        foreach(const QString& asset, this->sceneAssets(mScenes.first()))
+            if (! preload.contains(asset))
+                preload.append(asset);
+    }
+
+    data.insert("manifests", sceneAssets);
+    data.insert("prefetch", next);
+    data.insert("preload", preload);
+    return data;
+}
+
+//Biggest size each image is drawn at. Images that are also used where the size
+//isn't known (e.g. changing the background of another object) are left out.
+QHash<QString, QSize> DependencyAnalyzer::imageSizes() const
+{
+    QHash<QString, QSize> sizes;
+    QSet<QString> unbounded;
+
+    foreach(const QVariant& resource, mResources)
+        collectImageSizes(resource, "", QSize(), mGameSize, sizes, unbounded);
+
+    QVariantList scenes = mGameData.value("scenes").toList();
+    scenes.append(mGameData.value("pauseScreen").toMap().value("scenes").toList());
+    foreach(const QVariant& scene, scenes) {
+        QMapIterator<QString, QVariant> it(scene.toMap());
+        while(it.hasNext()) {
+            it.next();
+            collectImageSizes(it.value(), it.key(), mGameSize, mGameSize, sizes, unbounded);
+        }
+    }
+
+    foreach(const QString& image, unbounded)
+        sizes.remove(image);
+
+    return sizes;
+}
+
+void DependencyAnalyzer::collectImageSizes(const QVariant& value, const QString& key, const QSize& size, const QSize& parentSize,
+                                           QHash<QString, QSize>& sizes, QSet<QString>& unbounded) const
+{
+    if (value.type() == QVariant::Map) {
+        QVariantMap map = value.toMap();
+        QSize mapSize = objectSize(map, parentSize);
+        QSize childrenSize = mapSize.isValid() ? mapSize : parentSize;
+
+        QMapIterator<QString, QVariant> it(map);
+        while(it.hasNext()) {
+            it.next();
+            //character states map state names to images
+            if (it.key() == "states" && it.value().type() == QVariant::Map) {
+                foreach(const QVariant& state, it.value().toMap())
+                    collectImageSizes(state, "image", mapSize, childrenSize, sizes, unbounded);
+            }
+            else
+                collectImageSizes(it.value(), it.key(), mapSize, childrenSize, sizes, unbounded);
+        }
+    }
+    else if (value.type() == QVariant::List) {
+        foreach(const QVariant& item, value.toList())
+            collectImageSizes(item, key, size, parentSize, sizes, unbounded);
+    }
+    else if (value.type() == QVariant::String && key != "name" && key != "type") {
+        QString name = value.toString();
+        if (! mAssetNames.contains(name))
+            return;
+
+        bool imageKey = (key == "image" || key == "backgroundImage" || key == "emptyThumbnail");
+        if (imageKey && size.isValid())
+            sizes.insert(name, sizes.value(name).expandedTo(size));
+        else
+            unbounded.insert(name);
+    }
+}
+
+//Size of an object, taking missing values from its resource and percentages from its parent.
+//Scene background changes are drawn at the game size. Anything else has no size.
+QSize DependencyAnalyzer::objectSize(const QVariantMap& data, const QSize& parentSize) const
+{
+    if (data.value("type").toString() == "ChangeBackground")
+        return mGameSize;
+
+    QVariantMap resource = mResources.value(data.value("resource").toString()).toMap();
+    QVariant width = data.contains("width") ? data.value("width") : resource.value("width");
+    QVariant height = data.contains("height") ? data.value("height") : resource.value("height");
+    if (! width.isValid() || ! height.isValid())
+        return QSize();
+
+    int w = width.toInt();
+    int h = height.toInt();
+    if (width.toString().endsWith("%"))
+        w = parentSize.width() * width.toString().remove("%").toInt() / 100;
+    if (height.toString().endsWith("%"))
+        h = parentSize.height() * height.toString().remove("%").toInt() / 100;
+
+    if (w <= 0 || h <= 0)
+        return QSize();
+    return QSize(w, h);
+}
+
+//Characters shown with each font family (in lower case). Text from actions, like dialogues,
+//goes to the families of the dialogue boxes and to the default font. Families showing
+//variables or saved games can display anything, so they are left out, as is everything
+//when there are scripts.
+QHash<QString, QString> DependencyAnalyzer::fontCharacters() const
+{
+    QHash<QString, QString> texts;
+    QSet<QString> dynamic;
+    QSet<QString> fallbackFamilies;
+
+    if (hasScripts())
+        return texts;
+
+    foreach(const QVariant& resource, mResources)
+        collectText(resource, "", "", texts, dynamic, fallbackFamilies);
+
+    QVariantList scenes = mGameData.value("scenes").toList();
+    scenes.append(mGameData.value("pauseScreen").toMap().value("scenes").toList());
+    foreach(const QVariant& scene, scenes)
+        collectText(scene, "", "", texts, dynamic, fallbackFamilies);
+
+    QString defaultFamily = mGameData.value("font").toMap().value("family").toString().toLower();
+    if (! defaultFamily.isEmpty())
+        fallbackFamilies.insert(defaultFamily);
+
+    foreach(const QString& family, fallbackFamilies) {
+        texts[family].append(texts.value(""));
+        if (dynamic.contains(""))
+            dynamic.insert(family);
+    }
+
+    texts.remove("");
+    foreach(const QString& family, dynamic)
+        texts.remove(family);
+
+    return texts;
+}
+
+void DependencyAnalyzer::collectText(const QVariant& value, const QString& key, const QString& family, QHash<QString, QString>& texts,
+                                     QSet<QString>& dynamic, QSet<QString>& fallbackFamilies) const
+{
+    if (value.type() == QVariant::Map) {
+        QVariantMap map = value.toMap();
+        QString type = map.value("type").toString();
+        QString mapFamily = fontFamily(map);
+        //actions and objects without text don't have a known font, other maps use their parent's
+        if (mapFamily.isEmpty() && type.isEmpty())
+            mapFamily = family;
+
+        if (type == "DialogueBox" && ! mapFamily.isEmpty())
+            fallbackFamilies.insert(mapFamily);
+        if (type == "SlotButton")
+            dynamic.insert(mapFamily);
+
+        QMapIterator<QString, QVariant> it(map);
+        while(it.hasNext()) {
+            it.next();
+            collectText(it.value(), it.key(), mapFamily, texts, dynamic, fallbackFamilies);
+        }
+    }
+    else if (value.type() == QVariant::List) {
+        foreach(const QVariant& item, value.toList())
+            collectText(item, key, family, texts, dynamic, fallbackFamilies);
+    }
+    else if (value.type() == QVariant::String && (key == "text" || key == "character" || key == "speakerName")) {
+        QString text = value.toString();
+        texts[family].append(text);
+        if (text.contains(QRegExp("\\$[a-zA-Z_0-9]")))
+            dynamic.insert(family);
+    }
+}
+
+QString DependencyAnalyzer::fontFamily(const QVariantMap& data) const
+{
+    QVariant font = data.value("font");
+    if (! data.contains("font"))
+        font = mResources.value(data.value("resource").toString()).toMap().value("font");
+
+    //font string is deprecated, but old game files still use it
+    if (font.type() == QVariant::String)
+        return Utils::fontFamily(font.toString()).toLower();
+    return font.toMap().value("family").toString().toLower();
+}
+
+//Labels some GoToLabel in the scene jumps to, from its actions or its objects' events
+static void collectLabelTargets(const QVariant& value, QSet<QString>& labels)
+{
+    if (value.type() == QVariant::Map) {
+        QVariantMap map = value.toMap();
+        if (map.value("type").toString() == "GoToLabel")
+            labels.insert(map.value("label").toString());
+        foreach(const QVariant& item, map)
+            collectLabelTargets(item, labels);
+    }
+    else if (value.type() == QVariant::List) {
+        foreach(const QVariant& item, value.toList())
+            collectLabelTargets(item, labels);
+    }
+}
+
+DependencyAnalyzer::Dependencies DependencyAnalyzer::analyze(const QVariantMap& data, bool scene) const
+{
+    Dependencies deps;
+    collect(data, "", deps);
+
+    //a scene only moves to the following one if the end of its actions can be reached,
+    //an End or GoToScene can be skipped by jumping to any label after it
+    if (scene) {
+        QSet<QString> labels;
+        collectLabelTargets(data, labels);
+        bool reachable = true;
+        foreach(const QVariant& action, data.value("actions").toList()) {
+            QVariantMap map = action.toMap();
+            QString type = map.value("type").toString();
+            if (type == "Label" && labels.contains(map.value("name").toString()))
+                reachable = true;
+            else if (type == "End" || type == "GoToScene")
+                reachable = false;
+        }
+        deps.fallsThrough = reachable;
+    }
+    else
+        deps.fallsThrough = false;
+
+    return deps;
+}
+
+void DependencyAnalyzer::collect(const QVariant& value, const QString& key, Dependencies& deps) const
+{
+    if (value.type() == QVariant::Map) {
+        QVariantMap map = value.toMap();
+        QString type = map.value("type").toString();
+
+        if (type == "RunScript")
+            deps.hasScripts = true;
+        else if (type == "GoToScene") {
+            int metaTarget = map.value("metaTarget", GoToScene::None).toInt();
+            //targetType is deprecated, but old game files still use it
+            if (map.contains("targetType")) {
+                if (map.value("targetType").toInt() == 1)
+                    metaTarget = GoToScene::metaTargetFromString(map.value("target").toString());
+                else
+                    metaTarget = GoToScene::Name;
+            }
+
+            if (metaTarget == GoToScene::Name || metaTarget == GoToScene::None)
+                deps.sceneNames.insert(map.value("target").toString());
+            else
+                deps.metaTargets.insert(metaTarget);
+        }
+
+        QMapIterator<QString, QVariant> it(map);
+        while(it.hasNext()) {
+            it.next();
+            collect(it.value(), it.key(), deps);
+        }
+    }
+    else if (value.type() == QVariant::List) {
+        foreach(const QVariant& item, value.toList())
+            collect(item, key, deps);
+    }
+    else if (value.type() == QVariant::String && key != "name" && key != "type") {
+        QString str = value.toString();
+        if (mAssetNames.contains(str))
+            deps.assets.insert(str);
+        if (mResourceNames.contains(str))
+            deps.resources.insert(str);
+    }
+}
+
+//resources used directly plus the ones they use themselves
+QSet<QString> DependencyAnalyzer::resourcesClosure(const QSet<QString>& resources) const
+{
+    QSet<QString> closure;
+    QList<QString> pending = resources.toList();
+
+    while(! pending.isEmpty()) {
+        QString resource = pending.takeFirst();
+        if (closure.contains(resource))
+            continue;
+        closure.insert(resource);
+        pending.append(mResourceDependencies.value(resource).resources.toList());
+    }
+
+    return closure;
+}
+
+//scenes the pause screen jumps to, e.g. from its menu options, can be shown at any time
+QSet<QString> DependencyAnalyzer::pauseScreenTargets() const
+{
+    QSet<QString> targets;
+    foreach(const Dependencies& deps, mPauseSceneDependencies) {
+        targets.unite(deps.sceneNames);
+        foreach(const QString& resource, resourcesClosure(deps.resources))
+            targets.unite(mResourceDependencies.value(resource).sceneNames);
+    }
+
+    QSet<QString> scenes;
+    foreach(const QString& target, targets)
+        if (mScenes.contains(target))
+            scenes.insert(target);
+    return scenes;
+}
+
+QSet<QString> DependencyAnalyzer::assetsOf(const Dependencies& deps) const
+{
+    QSet<QString> assets = deps.assets;
+    foreach(const QString& resource, resourcesClosure(deps.resources))
+        assets.unite(mResourceDependencies.value(resource).assets);
+    return assets;
+}
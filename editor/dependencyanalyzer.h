@@ -0,0 +1,66 @@
+#ifndef DEPENDENCYANALYZER_H
+#define DEPENDENCYANALYZER_H
+
+#include <QHash>
+#include <QSet>
+#include <QSize>
+#include <QStringList>
+#include <QVariantMap>
+
+//Works on the serialized game data, so scenes don't need to be loaded in the editor.
+class DependencyAnalyzer
+{
+    struct Dependencies {
+        QSet<QString> assets;
+        QSet<QString> resources;
+        QSet<int> metaTargets;
+        QSet<QString> sceneNames;
+        bool hasScripts;
+        bool fallsThrough;
+        Dependencies() : hasScripts(false), fallsThrough(true) {}
+    };
+
+    QVariantMap mGameData;
+    QVariantMap mResources;
+    QSize mGameSize;
+    QStringList mScenes;
+    QStringList mPauseScenes;
+    QSet<QString> mAssetNames;
+    QSet<QString> mResourceNames;
+    QHash<QString, Dependencies> mSceneDependencies;
+    QHash<QString, Dependencies> mPauseSceneDependencies;
+    QHash<QString, Dependencies> mResourceDependencies;
+
+public:
+    DependencyAnalyzer(const QVariantMap& gameData, const QStringList& assetNames);
+    virtual ~DependencyAnalyzer();
+
+    QStringList scenes() const;
+    QStringList sceneAssets(const QString&) const;
+    QStringList sceneResources(const QString&) const;
+    QStringList nextScenes(const QString&) const;
+    QStringList pauseScreenAssets() const;
+    QStringList pauseScreenResources() const;
+    bool hasScripts() const;
+
+    QStringList reachableScenes() const;
+    QStringList usedResources() const;
+    QStringList usedAssets() const;
+
+    QVariantMap manifests() const;
+    QHash<QString, QSize> imageSizes() const;
+    QHash<QString, QString> fontCharacters() const;
+
+private:
+    void collect(const QVariant&, const QString&, Dependencies&) const;
+    Dependencies analyze(const QVariantMap&, bool scene=true) const;
+    QSet<QString> resourcesClosure(const QSet<QString>&) const;
+    QSet<QString> pauseScreenTargets() const;
+    QSet<QString> assetsOf(const Dependencies&) const;
+    void collectImageSizes(const QVariant&, const QString&, const QSize&, const QSize&, QHash<QString, QSize>&, QSet<QString>&) const;
+    QSize objectSize(const QVariantMap&, const QSize&) const;
+    void collectText(const QVariant&, const QString&, const QString&, QHash<QString, QString>&, QSet<QString>&, QSet<QString>&) const;
+    QString fontFamily(const QVariantMap&) const;
+};
+
+#endif // DEPENDENCYANALYZER_H
@@ -21,8 +21,10 @@
 #include <QFontDatabase>
 #include <QMenu>
 #include <QLayout>
+#include <QElapsedTimer>
 
 #include "textbox.h"
+#include "tracer.h"
 #include "scene.h"
 #include "objectgroup.h"
 
@@ -44,6 +46,8 @@ DrawingSurfaceWidget::DrawingSurfaceWidget(QWidget *parent) :
 
     mInstance = this;
     mObject = 0;
+    mShowPaintStatistics = false;
+    mOverlayUpdatePending = false;
 
     /*QWidget *widget = new QWidget(this);
     widget->setFixedHeight(Scene::height());
@@ -152,27 +156,77 @@ bool DrawingSurfaceWidget::eventFilter(QObject * obj, QEvent * event)
 
 void DrawingSurfaceWidget::paintEvent(QPaintEvent* paint)
 {
+    TraceSpan span("paint", "paint");
+    QElapsedTimer timer;
+    timer.start();
+
+    //repaints of just the overlay aren't counted, otherwise it would keep repainting itself
+    bool overlayOnly = mOverlayUpdatePending && mPaintStatistics.overlayRect(rect()).contains(paint->rect());
+    mOverlayUpdatePending = false;
+    PaintStatistics* statistics = 0;
+    if (mShowPaintStatistics && ! overlayOnly) {
+        statistics = &mPaintStatistics;
+        statistics->beginFrame();
+    }
 
     if (mObject)
-        paintObject(this);
+        paintObject(this, statistics);
     else if (mSceneManager && mSceneManager->currentScene())
-        paintSceneTo(this);
+        paintSceneTo(this, statistics);
     else
         return;
 
+    if (mShowPaintStatistics)
+        paintStatistics(paint, overlayOnly, timer.nsecsElapsed());
+
     emit paintFinished();
 }
 
-void DrawingSurfaceWidget::paintObject(QPaintDevice * paintDevice)
+void DrawingSurfaceWidget::paintStatistics(QPaintEvent* event, bool overlayOnly, qint64 nsecs)
+{
+    QPainter painter(this);
+    if (! overlayOnly) {
+        mPaintStatistics.endFrame(nsecs);
+        mPaintStatistics.paintRegion(painter, event->region());
+    }
+    mPaintStatistics.paint(painter, rect());
+
+    //when only part of the overlay was repainted, one more paint brings it up to date
+    QRect overlay = mPaintStatistics.overlayRect(rect());
+    if (! overlayOnly && ! event->rect().contains(overlay)) {
+        mOverlayUpdatePending = true;
+        update(overlay);
+    }
+}
+
+bool DrawingSurfaceWidget::showPaintStatistics() const
+{
+    return mShowPaintStatistics;
+}
+
+//Shows paint times, a histogram of the last frames, objects drawn by kind and what gets repainted
+void DrawingSurfaceWidget::setShowPaintStatistics(bool show)
+{
+    mShowPaintStatistics = show;
+    mOverlayUpdatePending = false;
+    mPaintStatistics.clear();
+    update();
+}
+
+void DrawingSurfaceWidget::paintObject(QPaintDevice * paintDevice, PaintStatistics* statistics)
 {
     if(! mObject)
         return;
 
+    QElapsedTimer timer;
+    timer.start();
     QPainter painter(paintDevice);
     painter.fillRect(0, 0, width(), height(), Qt::gray);
     painter.save();
     mObject->paint(painter);
     painter.restore();
+    if (statistics)
+        statistics->addObject(mObject, timer.nsecsElapsed());
     drawSelection(painter, mObject->selectedObject());
 }
 
@@ -198,7 +252,7 @@ Object* DrawingSurfaceWidget::object()
     return mObject;
 }
 
-void DrawingSurfaceWidget::paintSceneTo(QPaintDevice * paintDevice)
+void DrawingSurfaceWidget::paintSceneTo(QPaintDevice * paintDevice, PaintStatistics* statistics)
 {
     Scene *scene = mSceneManager->currentScene();
 
@@ -208,7 +262,7 @@ void DrawingSurfaceWidget::paintSceneTo(QPaintDevice * paintDevice)
     QPainter painter(paintDevice);
     painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
     painter.save();
-    scene->paint(painter);
+    scene->paint(painter, statistics);
     painter.restore();
     drawSelection(painter, scene->selectedObject());
 }
@@ -308,6 +362,8 @@ void DrawingSurfaceWidget::mouseMoveEvent( QMouseEvent * event)
 
     //if moving or resizing an object
     if (object && (mResizing || mMoving)) {
+        //a group being resized realigns its objects, their changes are sent once per step
+        ChangeBatch batch(object);
         if (mResizing) {
             object->resize(x, y);
         }
@@ -24,6 +24,7 @@
 #include <QScrollArea>
 
 #include "scene_manager.h"
+#include "paintstatistics.h"
 
 #define MARGIN 20
 
@@ -50,13 +51,16 @@ class DrawingSurfaceWidget : public QWidget
     QAction *mAlignHorizontally;
     QAction *mAlignVertically;
     Object* mObject;
+    PaintStatistics mPaintStatistics;
+    bool mShowPaintStatistics;
+    bool mOverlayUpdatePending;
     
     public:
         explicit DrawingSurfaceWidget(QWidget* parent=0);
         ~DrawingSurfaceWidget();
         virtual bool eventFilter(QObject *, QEvent *);
-        void paintSceneTo(QPaintDevice*);
-        void paintObject(QPaintDevice*);
+        void paintSceneTo(QPaintDevice*, PaintStatistics* statistics=0);
+        void paintObject(QPaintDevice*, PaintStatistics* statistics=0);
         void setObject(Object*);
         Object* object();
         void setSceneManager(SceneManager*);
@@ -64,6 +68,10 @@ class DrawingSurfaceWidget : public QWidget
         static QWidget* instance();
         Object* objectAt(qreal, qreal);
         Object* selectedObject();
+        bool showPaintStatistics() const;
+
+    public slots:
+        void setShowPaintStatistics(bool);
 
     protected:
         void paintEvent(QPaintEvent*);
@@ -96,6 +104,7 @@ class DrawingSurfaceWidget : public QWidget
 
    private:
         void performOperation(Clipboard::Operation);
+        void paintStatistics(QPaintEvent*, bool, qint64);
 
 };
 
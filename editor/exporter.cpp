@@ -0,0 +1,438 @@
+#include "exporter.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QObject>
+#include <QSet>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
+
+#include "engine.h"
+#include "assetmanager.h"
+#include "dependencyanalyzer.h"
+#include "conditioncompiler.h"
+#include "exportprogress.h"
+#include "gzipwriter.h"
+#include "tracer.h"
+
+static bool copyEngineFilesJob(const QDir& engineDir, const QDir& dir, bool overwrite, ExportProgress* progress)
+{
+    progress->startStage("copy engine files");
+    bool ok = Exporter::copyEngineFiles(engineDir, dir, overwrite);
+    progress->finishStage("copy engine files");
+    progress->advance();
+    return ok;
+}
+
+static bool writeGameFileJob(const QVariantMap& data, const QString& filepath, ExportProgress* progress)
+{
+    progress->startStage("write game file");
+    bool ok = Exporter::writeGameFile(data, filepath);
+    progress->finishStage("write game file");
+    progress->advance();
+    return ok;
+}
+
+struct CompressJob
+{
+    QString path;
+    ExportProgress* progress;
+};
+
+static void compressFile(CompressJob job)
+{
+    if (! job.progress || ! job.progress->isCanceled())
+        GzipWriter::compressFile(job.path);
+    if (job.progress)
+        job.progress->advance();
+}
+
+//Adds a "compiledCondition" to every branch whose condition can be turned into a plain expression
+static QVariant compileConditions(const QVariant& data, const QString& scene, ConditionCompiler& compiler, QStringList& errors)
+{
+    if (data.type() == QVariant::List) {
+        QVariantList list = data.toList();
+        for(int i=0; i < list.size(); i++)
+            list[i] = compileConditions(list[i], scene, compiler, errors);
+        return list;
+    }
+
+    if (data.type() != QVariant::Map)
+        return data;
+
+    QVariantMap map = data.toMap();
+    QVariantMap::iterator it;
+    for(it = map.begin(); it != map.end(); ++it)
+        it.value() = compileConditions(it.value(), scene, compiler, errors);
+
+    if (map.value("type").toString() == "Branch" && map.contains("condition")) {
+        QString expression;
+        if (compiler.compile(map.value("condition"), &expression))
+            map.insert("compiledCondition", expression);
+        foreach(const QString& error, compiler.errors())
+            errors << QObject::tr("Scene \"%1\": %2").arg(scene).arg(error);
+    }
+
+    return map;
+}
+
+static QVariantList compileSceneConditions(const QVariantList& scenes, QStringList& errors)
+{
+    ConditionCompiler compiler;
+    QVariantList compiled;
+    foreach(const QVariant& scene, scenes)
+        compiled.append(compileConditions(scene, scene.toMap().value("name").toString(), compiler, errors));
+    return compiled;
+}
+
+static void compileGameConditions(QVariantMap& gameData, QStringList& errors)
+{
+    gameData.insert("scenes", compileSceneConditions(gameData.value("scenes").toList(), errors));
+
+    if (gameData.contains("pauseScreen")) {
+        QVariantMap pauseScreen = gameData.value("pauseScreen").toMap();
+        pauseScreen.insert("scenes", compileSceneConditions(pauseScreen.value("scenes").toList(), errors));
+        gameData.insert("pauseScreen", pauseScreen);
+    }
+}
+
+Exporter::Exporter(const QVariantMap& gameData)
+{
+    mGameData = gameData;
+    mStripUnused = true;
+    mCompress = false;
+    mOptimizeAssets = true;
+    mProgress = 0;
+}
+
+Exporter::~Exporter()
+{
+}
+
+QVariantMap Exporter::gameData() const
+{
+    return mGameData;
+}
+
+void Exporter::setGameData(const QVariantMap& data)
+{
+    mGameData = data;
+}
+
+QString Exporter::errorString() const
+{
+    return mErrorString;
+}
+
+bool Exporter::stripUnused() const
+{
+    return mStripUnused;
+}
+
+void Exporter::setStripUnused(bool strip)
+{
+    mStripUnused = strip;
+}
+
+//Scenes, resources and assets left out of the last export
+QStringList Exporter::strippedItems() const
+{
+    return mStrippedItems;
+}
+
+//Branch conditions that couldn't be compiled in the last export; the engine interprets them instead
+QStringList Exporter::conditionErrors() const
+{
+    return mConditionErrors;
+}
+
+bool Exporter::compress() const
+{
+    return mCompress;
+}
+
+//Writes gzipped copies of the game data, engine scripts and styles next to them
+void Exporter::setCompress(bool compress)
+{
+    mCompress = compress;
+}
+
+bool Exporter::optimizeAssets() const
+{
+    return mOptimizeAssets;
+}
+
+//Merges duplicates, scales and re-encodes images, packs atlases and subsets fonts.
+//Without it the assets are copied as they are and files already in place are kept.
+void Exporter::setOptimizeAssets(bool optimize)
+{
+    mOptimizeAssets = optimize;
+}
+
+ExportProgress* Exporter::progress() const
+{
+    return mProgress;
+}
+
+//Receives the progress of the next exports and can be used to cancel them
+void Exporter::setProgress(ExportProgress* progress)
+{
+    mProgress = progress;
+}
+
+//Checks the game data against the assets currently loaded in the AssetManager.
+QStringList Exporter::validate() const
+{
+    QStringList errors;
+    AssetManager* assetManager = AssetManager::instance();
+
+    if (mGameData.value("scenes").type() != QVariant::List || mGameData.value("scenes").toList().isEmpty()) {
+        errors << QObject::tr("The game doesn't have any scenes.");
+        return errors;
+    }
+
+    if (mGameData.contains("resources") && mGameData.value("resources").type() != QVariant::Map)
+        errors << QObject::tr("The resources are not in a valid format.");
+
+    QVariantList scenes = mGameData.value("scenes").toList();
+    scenes.append(mGameData.value("pauseScreen").toMap().value("scenes").toList());
+    QSet<QString> names;
+
+    for(int i=0; i < scenes.size(); i++) {
+        if (scenes[i].type() != QVariant::Map) {
+            errors << QObject::tr("Scene %1 is not in a valid format.").arg(i);
+            continue;
+        }
+
+        QVariantMap scene = scenes[i].toMap();
+        QString name = scene.value("name").toString();
+        if (name.isEmpty())
+            errors << QObject::tr("Scene %1 doesn't have a name.").arg(i);
+        else if (names.contains(name))
+            errors << QObject::tr("There's more than one scene named \"%1\".").arg(name);
+        names.insert(name);
+
+        QString background = scene.value("backgroundImage").toString();
+        if (! background.isEmpty() && ! assetManager->asset(background, Asset::Image))
+            errors << QObject::tr("Scene \"%1\" uses a missing background image: %2").arg(name).arg(background);
+    }
+
+    //conditions that can't be compiled are left for the engine to interpret, see conditionErrors()
+    return errors;
+}
+
+bool Exporter::exportTo(const QDir& dir, bool overwriteEngineFiles)
+{
+    mErrorString = "";
+    mStrippedItems.clear();
+    mConditionErrors.clear();
+
+    if (! Engine::isValid()) {
+        mErrorString = QObject::tr("Invalid engine directory: %1").arg(Engine::path());
+        return false;
+    }
+
+    if (! dir.exists()) {
+        mErrorString = QObject::tr("The output directory doesn't exist: %1").arg(dir.absolutePath());
+        return false;
+    }
+
+    ExportProgress localProgress;
+    ExportProgress* progress = mProgress ? mProgress : &localProgress;
+    progress->startStage("export");
+
+    //the engine files are copied while the game is analyzed and the assets are exported
+    progress->addWork(2);
+    QFuture<bool> engineFuture = QtConcurrent::run(copyEngineFilesJob, QDir(Engine::path()), dir, overwriteEngineFiles, progress);
+
+    //copy images, sounds and fonts in use, along with what each scene needs so the engine can load them progressively
+    progress->startStage("analyze game");
+    AssetManager* assetManager = AssetManager::instance();
+    QStringList assetNames;
+    foreach(Asset* asset, assetManager->assets(Asset::Image) + assetManager->assets(Asset::Audio))
+        assetNames.append(asset->name());
+    DependencyAnalyzer analyzer(mGameData, assetNames);
+    QVariantMap gameData = mGameData;
+    QStringList excludedAssets;
+
+    //scenes that can't be reached and whatever only they use are left out
+    if (mStripUnused) {
+        QStringList reachableScenes = analyzer.reachableScenes();
+        QVariantList scenes;
+        foreach(const QVariant& scene, gameData.value("scenes").toList()) {
+            QString name = scene.toMap().value("name").toString();
+            if (reachableScenes.contains(name))
+                scenes.append(scene);
+            else
+                mStrippedItems.append(QObject::tr("Scene: %1").arg(name));
+        }
+        gameData.insert("scenes", scenes);
+
+        QStringList usedResources = analyzer.usedResources();
+        QVariantMap resources = gameData.value("resources").toMap();
+        foreach(const QString& name, resources.keys()) {
+            if (! usedResources.contains(name)) {
+                resources.remove(name);
+                mStrippedItems.append(QObject::tr("Resource: %1").arg(name));
+            }
+        }
+        if (gameData.contains("resources"))
+            gameData.insert("resources", resources);
+
+        QStringList usedAssets = analyzer.usedAssets();
+        foreach(const QString& name, assetNames) {
+            if (! usedAssets.contains(name)) {
+                excludedAssets.append(name);
+                mStrippedItems.append(QObject::tr("Asset: %1").arg(name));
+            }
+        }
+    }
+
+    progress->startStage("compile conditions");
+    compileGameConditions(gameData, mConditionErrors);
+    progress->finishStage("compile conditions");
+
+    QString gameFilePath = dir.absoluteFilePath(GAME_FILENAME);
+    QFuture<bool> gameFileFuture = QtConcurrent::run(writeGameFileJob, gameData, gameFilePath, progress);
+
+    AssetExportOptions options;
+    options.progress = progress;
+    options.optimize = mOptimizeAssets;
+    options.excluded = excludedAssets;
+    if (! mStrippedItems.isEmpty())
+        options.extraData = DependencyAnalyzer(gameData, assetNames).manifests();
+    else
+        options.extraData = analyzer.manifests();
+    //images are scaled down to the biggest size they're shown at
+    options.imageSizes = analyzer.imageSizes();
+    options.fontCharacters = analyzer.fontCharacters();
+    options.imageQuality = gameData.value("imageQuality").toInt();
+    if (gameData.contains("imageFormat"))
+        options.imageFormat = gameData.value("imageFormat").toString().toLatin1();
+    progress->finishStage("analyze game");
+    bool assetsSaved = assetManager->save(dir, false, options);
+
+    progress->waitFor(engineFuture);
+    progress->waitFor(gameFileFuture);
+    if (! progress->isCanceled())
+        compressTextFiles(dir, mCompress, progress);
+    progress->finishStage("export");
+
+    if (progress->isCanceled()) {
+        mErrorString = QObject::tr("The export was canceled.");
+        return false;
+    }
+
+    if (! engineFuture.result()) {
+        mErrorString = QObject::tr("Couldn't copy the engine files to %1").arg(dir.absolutePath());
+        return false;
+    }
+
+    if (! gameFileFuture.result()) {
+        mErrorString = QObject::tr("Couldn't write the game file to %1").arg(gameFilePath);
+        return false;
+    }
+
+    if (! assetsSaved) {
+        mErrorString = QObject::tr("Couldn't write the assets to %1").arg(dir.absolutePath());
+        if (! assetManager->errorString().isEmpty())
+            mErrorString += "\n" + assetManager->errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QVariantMap Exporter::readGameFile(const QString& filepath)
+{
+    TraceSpan span("read game file", "project", filepath);
+    QVariantMap dataMap;
+
+    QFile file(filepath);
+    if (! file.open(QFile::ReadOnly))
+        return dataMap;
+
+    QByteArray contents = file.readAll();
+    file.close();
+
+    //if new game file format, just remove start ("game.data =")
+    int i = 0;
+    for(i=0; i < contents.size() && contents[i] != '{'; i++);
+    contents = contents.mid(i);
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(contents, &error);
+    if (error.error != QJsonParseError::NoError)
+        return dataMap;
+
+    QVariant data = doc.toVariant();
+    if (data.type() != QVariant::Map)
+        return dataMap;
+
+    return data.toMap();
+}
+
+bool Exporter::writeGameFile(const QVariantMap& data, const QString& filepath)
+{
+    TraceSpan span("write game file", "project", filepath);
+    //the previous file is only replaced once the new one was completely written
+    QSaveFile file(filepath);
+
+    if (! file.open(QFile::WriteOnly))
+        return false;
+
+    file.write("game.data = ");
+    file.write(QJsonDocument::fromVariant(data).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+bool Exporter::copyEngineFiles(const QDir& engineDir, const QDir& dir, bool overwrite)
+{
+    QStringList fileNames = engineDir.entryList(QStringList() << "*.js" << "*.html" << "*.css", QDir::Files | QDir::NoSymLinks | QDir::NoDotAndDotDot);
+    bool ok = true;
+
+    foreach(const QString&fileName, fileNames) {
+        bool exists = QFile::exists(dir.absoluteFilePath(fileName));
+        if (overwrite && exists) {
+            QFile::remove(dir.absoluteFilePath(fileName));
+            exists = false;
+        }
+
+        //existing files are kept from previous runs
+        if (! exists && ! QFile::copy(engineDir.absoluteFilePath(fileName), dir.absoluteFilePath(fileName)))
+            ok = false;
+    }
+
+    return ok;
+}
+
+//Gzipped copies left from previous exports are removed when not compressing, so they're never stale
+void Exporter::compressTextFiles(const QDir& dir, bool compress, ExportProgress* progress)
+{
+    QStringList fileNames = dir.entryList(QStringList() << "*.js" << "*.css", QDir::Files | QDir::NoDotAndDotDot);
+    if (! compress) {
+        foreach(const QString& fileName, fileNames)
+            QFile::remove(dir.absoluteFilePath(fileName + ".gz"));
+        return;
+    }
+
+    QList<CompressJob> jobs;
+    foreach(const QString& fileName, fileNames) {
+        CompressJob job;
+        job.path = dir.absoluteFilePath(fileName);
+        job.progress = progress;
+        jobs.append(job);
+    }
+
+    if (progress) {
+        progress->startStage("compress");
+        progress->addWork(jobs.size());
+        progress->waitFor(QtConcurrent::map(jobs, compressFile));
+        progress->finishStage("compress");
+    }
+    else {
+        QtConcurrent::blockingMap(jobs, compressFile);
+    }
+}
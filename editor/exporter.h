@@ -0,0 +1,56 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <QDir>
+#include <QVariantMap>
+#include <QString>
+#include <QStringList>
+
+#define GAME_FILENAME "game_data.js"
+
+class ExportProgress;
+
+class Exporter
+{
+public:
+    Exporter(const QVariantMap& gameData=QVariantMap());
+    virtual ~Exporter();
+
+    QVariantMap gameData() const;
+    void setGameData(const QVariantMap&);
+
+    QStringList validate() const;
+    bool exportTo(const QDir&, bool overwriteEngineFiles=false);
+    QString errorString() const;
+
+    bool stripUnused() const;
+    void setStripUnused(bool);
+    QStringList strippedItems() const;
+    QStringList conditionErrors() const;
+
+    bool compress() const;
+    void setCompress(bool);
+
+    bool optimizeAssets() const;
+    void setOptimizeAssets(bool);
+
+    ExportProgress* progress() const;
+    void setProgress(ExportProgress*);
+
+    static QVariantMap readGameFile(const QString&);
+    static bool writeGameFile(const QVariantMap&, const QString&);
+    static bool copyEngineFiles(const QDir&, const QDir&, bool overwrite=false);
+    static void compressTextFiles(const QDir&, bool compress, ExportProgress* progress=0);
+
+private:
+    QVariantMap mGameData;
+    QString mErrorString;
+    bool mStripUnused;
+    bool mCompress;
+    bool mOptimizeAssets;
+    QStringList mStrippedItems;
+    QStringList mConditionErrors;
+    ExportProgress* mProgress;
+};
+
+#endif // EXPORTER_H
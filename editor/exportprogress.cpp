@@ -0,0 +1,118 @@
+#include "exportprogress.h"
+
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QMutexLocker>
+#include <QThread>
+
+#include "tracer.h"
+
+ExportProgress::ExportProgress(QObject *parent) :
+    QObject(parent)
+{
+    mTimer.start();
+}
+
+ExportProgress::~ExportProgress()
+{
+}
+
+void ExportProgress::addWork(int steps)
+{
+    emit maximumChanged(mMaximum.fetchAndAddOrdered(steps) + steps);
+}
+
+void ExportProgress::advance(int steps)
+{
+    emit valueChanged(mValue.fetchAndAddOrdered(steps) + steps);
+}
+
+int ExportProgress::value() const
+{
+    return mValue.load();
+}
+
+int ExportProgress::maximum() const
+{
+    return mMaximum.load();
+}
+
+bool ExportProgress::isCanceled() const
+{
+    return mCanceled.load() != 0;
+}
+
+void ExportProgress::cancel()
+{
+    mCanceled.store(1);
+
+    QMutexLocker locker(&mMutex);
+    for(int i=0; i < mFutures.size(); i++)
+        mFutures[i].cancel();
+}
+
+void ExportProgress::startStage(const QString& stage)
+{
+    QMutexLocker locker(&mMutex);
+    mStageStarts.insert(stage, mTimer.elapsed());
+    if (Tracer::isEnabled())
+        mTraceStarts.insert(stage, Tracer::now());
+}
+
+void ExportProgress::finishStage(const QString& stage)
+{
+    qint64 elapsed = 0;
+    {
+        QMutexLocker locker(&mMutex);
+        if (! mStageStarts.contains(stage))
+            return;
+        elapsed = mTimer.elapsed() - mStageStarts.take(stage);
+        mTimings.append(QString("%1: %2 ms").arg(stage).arg(elapsed));
+        if (mTraceStarts.contains(stage)) {
+            qint64 start = mTraceStarts.take(stage);
+            Tracer::addEvent(stage.toUtf8(), "export", start, Tracer::now() - start);
+        }
+    }
+
+    emit stageFinished(stage, elapsed);
+}
+
+QStringList ExportProgress::timings() const
+{
+    QMutexLocker locker(&mMutex);
+    return mTimings;
+}
+
+//Keeps the event loop running while waiting in the GUI thread, so the progress
+//dialog is updated and can be used to cancel.
+void ExportProgress::waitFor(const QFuture<void>& future)
+{
+    QFuture<void> pending = future;
+    {
+        QMutexLocker locker(&mMutex);
+        mFutures.append(pending);
+    }
+
+    if (isCanceled())
+        pending.cancel();
+
+    QCoreApplication* app = QCoreApplication::instance();
+    if (app && QThread::currentThread() == app->thread()) {
+        QFutureWatcher<void> watcher;
+        QEventLoop loop;
+        connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+        watcher.setFuture(pending);
+        if (! pending.isFinished())
+            loop.exec();
+    }
+    pending.waitForFinished();
+
+    QMutexLocker locker(&mMutex);
+    for(int i=0; i < mFutures.size(); i++) {
+        if (mFutures[i] == pending) {
+            mFutures.removeAt(i);
+            break;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef EXPORTPROGRESS_H
+#define EXPORTPROGRESS_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QStringList>
+
+//Shared by the export jobs running on the thread pool. Counts finished jobs,
+//lets the user cancel and keeps how long each stage took.
+class ExportProgress : public QObject
+{
+    Q_OBJECT
+
+    QAtomicInt mValue;
+    QAtomicInt mMaximum;
+    QAtomicInt mCanceled;
+    mutable QMutex mMutex;
+    QElapsedTimer mTimer;
+    QHash<QString, qint64> mStageStarts;
+    QHash<QString, qint64> mTraceStarts;
+    QStringList mTimings;
+    QList<QFuture<void> > mFutures;
+
+public:
+    explicit ExportProgress(QObject *parent = 0);
+    virtual ~ExportProgress();
+
+    void addWork(int);
+    void advance(int steps=1);
+    int value() const;
+    int maximum() const;
+    bool isCanceled() const;
+
+    void startStage(const QString&);
+    void finishStage(const QString&);
+    QStringList timings() const;
+
+    void waitFor(const QFuture<void>&);
+
+signals:
+    void valueChanged(int);
+    void maximumChanged(int);
+    void stageFinished(const QString&, qint64);
+
+public slots:
+    void cancel();
+
+};
+
+#endif // EXPORTPROGRESS_H
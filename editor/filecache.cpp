@@ -0,0 +1,144 @@
+#include "filecache.h"
+
+#include <QFileInfo>
+#include <QMutexLocker>
+
+FileCache::FileCache(QObject *parent) :
+    QObject(parent)
+{
+    mSize = 0;
+    mMaxSize = FILE_CACHE_SIZE;
+    mWatcher = new QFileSystemWatcher(this);
+
+    connect(mWatcher, SIGNAL(fileChanged(const QString&)), this, SLOT(onFileChanged(const QString&)));
+    connect(mWatcher, SIGNAL(directoryChanged(const QString&)), this, SLOT(onDirectoryChanged(const QString&)));
+    //queued when inserting from the server threads
+    connect(this, SIGNAL(watchRequested(const QStringList&)), this, SLOT(watch(const QStringList&)));
+}
+
+FileCache::~FileCache()
+{
+}
+
+bool FileCache::lookup(const QString& key, CachedFile* file)
+{
+    QMutexLocker locker(&mMutex);
+    if (! mFiles.contains(key))
+        return false;
+
+    mRecent.removeOne(key);
+    mRecent.append(key);
+    if (file)
+        *file = mFiles.value(key);
+    return true;
+}
+
+void FileCache::insert(const QString& key, const CachedFile& file)
+{
+    if (file.data.size() > FILE_CACHE_MAX_FILE_SIZE)
+        return;
+
+    {
+        QMutexLocker locker(&mMutex);
+        if (file.data.size() > mMaxSize)
+            return;
+        _remove(key);
+
+        //least recently used files go first
+        while(! mRecent.isEmpty() && mSize + file.data.size() > mMaxSize)
+            _remove(mRecent.first());
+
+        mFiles.insert(key, file);
+        mRecent.append(key);
+        mSize += file.data.size();
+    }
+
+    emit watchRequested(file.files);
+}
+
+void FileCache::remove(const QString& key)
+{
+    QMutexLocker locker(&mMutex);
+    _remove(key);
+}
+
+void FileCache::_remove(const QString& key)
+{
+    if (! mFiles.contains(key))
+        return;
+
+    mSize -= mFiles.take(key).data.size();
+    mRecent.removeOne(key);
+}
+
+void FileCache::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mFiles.clear();
+    mRecent.clear();
+    mSize = 0;
+}
+
+qint64 FileCache::size() const
+{
+    QMutexLocker locker(&mMutex);
+    return mSize;
+}
+
+qint64 FileCache::maxSize() const
+{
+    QMutexLocker locker(&mMutex);
+    return mMaxSize;
+}
+
+void FileCache::setMaxSize(qint64 size)
+{
+    QMutexLocker locker(&mMutex);
+    mMaxSize = size;
+    while(! mRecent.isEmpty() && mSize > mMaxSize)
+        _remove(mRecent.first());
+}
+
+//Directories are watched too, so new or replaced files (e.g. a new .gz copy) are noticed
+void FileCache::watch(const QStringList& files)
+{
+    QStringList paths;
+    foreach(const QString& file, files) {
+        QString dir = QFileInfo(file).absolutePath();
+        if (! mWatcher->files().contains(file))
+            paths.append(file);
+        if (! mWatcher->directories().contains(dir) && ! paths.contains(dir))
+            paths.append(dir);
+    }
+
+    if (! paths.isEmpty())
+        mWatcher->addPaths(paths);
+}
+
+void FileCache::removeUsing(const QString& path)
+{
+    QMutexLocker locker(&mMutex);
+    QStringList keys = mFiles.keys();
+    foreach(const QString& key, keys) {
+        QStringList files = mFiles.value(key).files;
+        foreach(const QString& filePath, files) {
+            if (filePath == path || QFileInfo(filePath).absolutePath() == path) {
+                _remove(key);
+                break;
+            }
+        }
+    }
+}
+
+void FileCache::onFileChanged(const QString& path)
+{
+    removeUsing(path);
+    //replaced files stop being watched
+    if (mWatcher->files().contains(path) && ! QFileInfo(path).exists())
+        mWatcher->removePath(path);
+}
+
+void FileCache::onDirectoryChanged(const QString& path)
+{
+    removeUsing(path);
+}
@@ -0,0 +1,64 @@
+#ifndef FILECACHE_H
+#define FILECACHE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+
+#define FILE_CACHE_SIZE (64 * 1024 * 1024)
+#define FILE_CACHE_MAX_FILE_SIZE (1024 * 1024)
+
+struct CachedFile
+{
+    QByteArray data;
+    QString mimetype;
+    QString lastModified;
+    QString etag;
+    bool compressed;
+    QStringList files; //files on disk it was read from
+
+    CachedFile() : compressed(false) {}
+};
+
+//Keeps the contents and headers of the most recently served files. Can be used from any thread,
+//the watcher lives in the thread the cache was created in and drops entries whose files change.
+class FileCache : public QObject
+{
+    Q_OBJECT
+
+    QHash<QString, CachedFile> mFiles;
+    QStringList mRecent;
+    qint64 mSize;
+    qint64 mMaxSize;
+    QFileSystemWatcher* mWatcher;
+    mutable QMutex mMutex;
+
+public:
+    explicit FileCache(QObject *parent = 0);
+    virtual ~FileCache();
+
+    bool lookup(const QString&, CachedFile*);
+    void insert(const QString&, const CachedFile&);
+    void remove(const QString&);
+    void clear();
+    qint64 size() const;
+    qint64 maxSize() const;
+    void setMaxSize(qint64);
+
+signals:
+    void watchRequested(const QStringList&);
+
+private slots:
+    void watch(const QStringList&);
+    void onFileChanged(const QString&);
+    void onDirectoryChanged(const QString&);
+
+private:
+    void _remove(const QString&);
+    void removeUsing(const QString&);
+};
+
+#endif // FILECACHE_H
@@ -0,0 +1,521 @@
+#include "fontsubsetter.h"
+
+#include <QList>
+#include <QVector>
+#include <QtEndian>
+
+#define SFNT_TRUETYPE 0x00010000
+#define SFNT_TRUE 0x74727565
+#define WOFF_SIGNATURE 0x774F4646
+#define CHECKSUM_MAGIC 0xB1B0AFBA
+
+//composite glyph flags
+#define ARG_1_AND_2_ARE_WORDS 0x0001
+#define WE_HAVE_A_SCALE 0x0008
+#define MORE_COMPONENTS 0x0020
+#define WE_HAVE_AN_X_AND_Y_SCALE 0x0040
+#define WE_HAVE_A_TWO_BY_TWO 0x0080
+
+static quint16 readU16(const QByteArray& data, int offset)
+{
+    if (offset < 0 || offset + 2 > data.size())
+        return 0;
+    return qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(data.constData() + offset));
+}
+
+static quint32 readU32(const QByteArray& data, int offset)
+{
+    if (offset < 0 || offset + 4 > data.size())
+        return 0;
+    return qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(data.constData() + offset));
+}
+
+static void writeU16(QByteArray& data, int offset, quint16 value)
+{
+    qToBigEndian<quint16>(value, reinterpret_cast<uchar*>(data.data() + offset));
+}
+
+static void writeU32(QByteArray& data, int offset, quint32 value)
+{
+    qToBigEndian<quint32>(value, reinterpret_cast<uchar*>(data.data() + offset));
+}
+
+static void appendU16(QByteArray& data, quint16 value)
+{
+    data.append(QByteArray(2, 0));
+    writeU16(data, data.size()-2, value);
+}
+
+static void appendU32(QByteArray& data, quint32 value)
+{
+    data.append(QByteArray(4, 0));
+    writeU32(data, data.size()-4, value);
+}
+
+static void pad(QByteArray& data)
+{
+    while(data.size() % 4)
+        data.append('\0');
+}
+
+static quint32 checksum(const QByteArray& data)
+{
+    QByteArray padded = data;
+    pad(padded);
+
+    quint32 sum = 0;
+    for(int i=0; i < padded.size(); i += 4)
+        sum += readU32(padded, i);
+    return sum;
+}
+
+//the head checksum is calculated with checkSumAdjustment set to 0
+static quint32 tableChecksum(const QByteArray& tag, const QByteArray& table)
+{
+    if (tag == "head" && table.size() >= 12) {
+        QByteArray head = table;
+        writeU32(head, 8, 0);
+        return checksum(head);
+    }
+
+    return checksum(table);
+}
+
+FontSubsetter::FontSubsetter()
+{
+    mFlavor = SFNT_TRUETYPE;
+    mWoff = false;
+}
+
+FontSubsetter::~FontSubsetter()
+{
+}
+
+bool FontSubsetter::load(const QByteArray& data)
+{
+    mTables.clear();
+    mWoff = readU32(data, 0) == WOFF_SIGNATURE;
+
+    if (mWoff)
+        return loadWoff(data);
+    return loadSfnt(data);
+}
+
+bool FontSubsetter::loadSfnt(const QByteArray& data)
+{
+    mFlavor = readU32(data, 0);
+    if (mFlavor != SFNT_TRUETYPE && mFlavor != SFNT_TRUE)
+        return false;
+
+    int numTables = readU16(data, 4);
+    for(int i=0; i < numTables; i++) {
+        int record = 12 + i * 16;
+        quint32 offset = readU32(data, record + 8);
+        quint32 length = readU32(data, record + 12);
+        if (record + 16 > data.size() || offset + length > quint32(data.size()))
+            return false;
+        mTables.insert(data.mid(record, 4), data.mid(offset, length));
+    }
+
+    return ! mTables.isEmpty();
+}
+
+bool FontSubsetter::loadWoff(const QByteArray& data)
+{
+    mFlavor = readU32(data, 4);
+    if (mFlavor != SFNT_TRUETYPE && mFlavor != SFNT_TRUE)
+        return false;
+
+    int numTables = readU16(data, 12);
+    for(int i=0; i < numTables; i++) {
+        int entry = 44 + i * 20;
+        quint32 offset = readU32(data, entry + 4);
+        quint32 compLength = readU32(data, entry + 8);
+        quint32 origLength = readU32(data, entry + 12);
+        if (entry + 20 > data.size() || offset + compLength > quint32(data.size()))
+            return false;
+
+        QByteArray table = data.mid(offset, compLength);
+        //qUncompress expects the uncompressed size before the zlib stream
+        if (compLength < origLength) {
+            QByteArray compressed(4, 0);
+            writeU32(compressed, 0, origLength);
+            table = qUncompress(compressed + table);
+        }
+
+        if (quint32(table.size()) != origLength)
+            return false;
+        mTables.insert(data.mid(entry, 4), table);
+    }
+
+    return ! mTables.isEmpty();
+}
+
+bool FontSubsetter::isWoff() const
+{
+    return mWoff;
+}
+
+//Keeps the outlines of the glyphs needed by the given characters, along with
+//the glyphs GSUB can substitute in, the components of composite glyphs and the .notdef glyph.
+bool FontSubsetter::subset(const QSet<uint>& characters)
+{
+    if (! mTables.contains("head") || ! mTables.contains("maxp") || ! mTables.contains("loca") ||
+        ! mTables.contains("glyf") || ! mTables.contains("cmap"))
+        return false;
+
+    QByteArray head = mTables.value("head");
+    QByteArray loca = mTables.value("loca");
+    QByteArray glyf = mTables.value("glyf");
+    int numGlyphs = readU16(mTables.value("maxp"), 4);
+    bool longOffsets = readU16(head, 50) == 1;
+    if (head.size() < 54 || numGlyphs == 0)
+        return false;
+
+    QVector<quint32> offsets(numGlyphs + 1);
+    for(int i=0; i <= numGlyphs; i++)
+        offsets[i] = longOffsets ? readU32(loca, i * 4) : readU16(loca, i * 2) * 2;
+
+    QSet<quint16> glyphs;
+    QList<quint16> pending;
+    pending.append(0);
+    foreach(uint character, characters)
+        pending.append(glyphIndex(character));
+    //ligatures, contextual and vertical forms aren't in the cmap
+    pending.append(substitutes().toList());
+
+    while(! pending.isEmpty()) {
+        quint16 glyph = pending.takeFirst();
+        if (glyph >= numGlyphs || glyphs.contains(glyph))
+            continue;
+        glyphs.insert(glyph);
+
+        QSet<quint16> components;
+        addComponents(glyf.mid(offsets[glyph], offsets[glyph+1] - offsets[glyph]), components);
+        pending.append(components.toList());
+    }
+
+    QByteArray newGlyf;
+    QVector<quint32> newOffsets(numGlyphs + 1);
+    for(int i=0; i < numGlyphs; i++) {
+        newOffsets[i] = newGlyf.size();
+        if (glyphs.contains(i) && offsets[i] < offsets[i+1]) {
+            newGlyf.append(glyf.mid(offsets[i], offsets[i+1] - offsets[i]));
+            pad(newGlyf);
+        }
+    }
+    newOffsets[numGlyphs] = newGlyf.size();
+
+    //short offsets are stored divided by two
+    longOffsets = newGlyf.size() / 2 > 0xFFFF;
+    QByteArray newLoca;
+    for(int i=0; i <= numGlyphs; i++) {
+        if (longOffsets)
+            appendU32(newLoca, newOffsets[i]);
+        else
+            appendU16(newLoca, newOffsets[i] / 2);
+    }
+
+    writeU16(head, 50, longOffsets ? 1 : 0);
+    writeU32(head, 8, 0);
+    mTables.insert("head", head);
+    mTables.insert("loca", newLoca);
+    mTables.insert("glyf", newGlyf);
+    //the signature doesn't match the changed font anymore
+    mTables.remove("DSIG");
+    return true;
+}
+
+QByteArray FontSubsetter::data() const
+{
+    if (mWoff)
+        return toWoff();
+    return toSfnt();
+}
+
+QByteArray FontSubsetter::toSfnt() const
+{
+    int numTables = mTables.size();
+    int entrySelector = 0;
+    while((1 << (entrySelector + 1)) <= numTables)
+        entrySelector++;
+    int searchRange = (1 << entrySelector) * 16;
+
+    QByteArray data;
+    appendU32(data, mFlavor);
+    appendU16(data, numTables);
+    appendU16(data, searchRange);
+    appendU16(data, entrySelector);
+    appendU16(data, numTables * 16 - searchRange);
+
+    QByteArray tables;
+    int offset = 12 + numTables * 16;
+    int headOffset = -1;
+    QMapIterator<QByteArray, QByteArray> it(mTables);
+    while(it.hasNext()) {
+        it.next();
+        if (it.key() == "head")
+            headOffset = offset + tables.size();
+
+        data.append(it.key());
+        appendU32(data, tableChecksum(it.key(), it.value()));
+        appendU32(data, offset + tables.size());
+        appendU32(data, it.value().size());
+        tables.append(it.value());
+        pad(tables);
+    }
+
+    data.append(tables);
+    if (headOffset != -1) {
+        writeU32(data, headOffset + 8, 0);
+        writeU32(data, headOffset + 8, CHECKSUM_MAGIC - checksum(data));
+    }
+
+    return data;
+}
+
+QByteArray FontSubsetter::toWoff() const
+{
+    //the head table needs the checksum adjustment of the whole sfnt
+    FontSubsetter sfnt;
+    if (! sfnt.loadSfnt(toSfnt()))
+        return QByteArray();
+
+    int numTables = sfnt.mTables.size();
+    quint32 totalSfntSize = 12 + numTables * 16;
+    QByteArray directory;
+    QByteArray tables;
+    int offset = 44 + numTables * 20;
+
+    QMapIterator<QByteArray, QByteArray> it(sfnt.mTables);
+    while(it.hasNext()) {
+        it.next();
+        //qCompress prepends the uncompressed size, which isn't part of the zlib stream
+        QByteArray table = qCompress(it.value()).mid(4);
+        if (table.size() >= it.value().size())
+            table = it.value();
+
+        directory.append(it.key());
+        appendU32(directory, offset + tables.size());
+        appendU32(directory, table.size());
+        appendU32(directory, it.value().size());
+        appendU32(directory, tableChecksum(it.key(), it.value()));
+        tables.append(table);
+        pad(tables);
+        totalSfntSize += (it.value().size() + 3) & ~3;
+    }
+
+    QByteArray data;
+    appendU32(data, WOFF_SIGNATURE);
+    appendU32(data, mFlavor);
+    appendU32(data, 44 + directory.size() + tables.size());
+    appendU16(data, numTables);
+    appendU16(data, 0);
+    appendU32(data, totalSfntSize);
+    appendU16(data, 1);
+    appendU16(data, 0);
+    for(int i=0; i < 5; i++)
+        appendU32(data, 0);
+
+    return data + directory + tables;
+}
+
+//Looks the character up in the unicode cmap subtables (formats 4 and 12)
+quint16 FontSubsetter::glyphIndex(uint character) const
+{
+    QByteArray cmap = mTables.value("cmap");
+    int numTables = readU16(cmap, 2);
+
+    for(int i=0; i < numTables; i++) {
+        int record = 4 + i * 8;
+        quint16 platform = readU16(cmap, record);
+        quint16 encoding = readU16(cmap, record + 2);
+        int sub = readU32(cmap, record + 4);
+        if (platform != 0 && ! (platform == 3 && (encoding == 1 || encoding == 10)))
+            continue;
+
+        quint16 format = readU16(cmap, sub);
+        if (format == 4 && character <= 0xFFFF) {
+            int segCountX2 = readU16(cmap, sub + 6);
+            int endCodes = sub + 14;
+            int startCodes = endCodes + segCountX2 + 2;
+            int idDeltas = startCodes + segCountX2;
+            int idRangeOffsets = idDeltas + segCountX2;
+
+            for(int seg=0; seg < segCountX2 / 2; seg++) {
+                if (character > readU16(cmap, endCodes + seg * 2))
+                    continue;
+
+                quint16 start = readU16(cmap, startCodes + seg * 2);
+                if (character < start)
+                    break;
+
+                quint16 delta = readU16(cmap, idDeltas + seg * 2);
+                quint16 rangeOffset = readU16(cmap, idRangeOffsets + seg * 2);
+                quint16 glyph = 0;
+                if (rangeOffset == 0)
+                    glyph = (character + delta) & 0xFFFF;
+                else {
+                    glyph = readU16(cmap, idRangeOffsets + seg * 2 + rangeOffset + (character - start) * 2);
+                    if (glyph)
+                        glyph = (glyph + delta) & 0xFFFF;
+                }
+
+                if (glyph)
+                    return glyph;
+                break;
+            }
+        }
+        else if (format == 12) {
+            quint32 numGroups = readU32(cmap, sub + 12);
+            for(quint32 group=0; group < numGroups; group++) {
+                int offset = sub + 16 + group * 12;
+                quint32 start = readU32(cmap, offset);
+                quint32 end = readU32(cmap, offset + 4);
+                if (character >= start && character <= end)
+                    return readU32(cmap, offset + 8) + (character - start);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static QList<quint16> coverageGlyphs(const QByteArray& gsub, int offset)
+{
+    QList<quint16> glyphs;
+    quint16 format = readU16(gsub, offset);
+    int count = readU16(gsub, offset + 2);
+    for(int i=0; i < count; i++) {
+        if (format == 1)
+            glyphs.append(readU16(gsub, offset + 4 + i * 2));
+        else if (format == 2) {
+            int record = offset + 4 + i * 6;
+            for(int glyph=readU16(gsub, record); glyph <= readU16(gsub, record + 2); glyph++)
+                glyphs.append(glyph);
+        }
+    }
+    return glyphs;
+}
+
+static void addSubstitutes(const QByteArray& gsub, int type, int subtable, QSet<quint16>& glyphs)
+{
+    quint16 format = readU16(gsub, subtable);
+
+    switch(type) {
+    case 1: //single
+        if (format == 1) {
+            quint16 delta = readU16(gsub, subtable + 4);
+            foreach(quint16 glyph, coverageGlyphs(gsub, subtable + readU16(gsub, subtable + 2)))
+                glyphs.insert(quint16(glyph + delta));
+        }
+        else if (format == 2) {
+            int count = readU16(gsub, subtable + 4);
+            for(int i=0; i < count; i++)
+                glyphs.insert(readU16(gsub, subtable + 6 + i * 2));
+        }
+        break;
+    case 2: //multiple
+    case 3: { //alternate
+        int count = readU16(gsub, subtable + 4);
+        for(int i=0; i < count; i++) {
+            int set = subtable + readU16(gsub, subtable + 6 + i * 2);
+            int setCount = readU16(gsub, set);
+            for(int j=0; j < setCount; j++)
+                glyphs.insert(readU16(gsub, set + 2 + j * 2));
+        }
+        break;
+    }
+    case 4: { //ligature
+        int count = readU16(gsub, subtable + 4);
+        for(int i=0; i < count; i++) {
+            int set = subtable + readU16(gsub, subtable + 6 + i * 2);
+            int ligatureCount = readU16(gsub, set);
+            for(int j=0; j < ligatureCount; j++)
+                glyphs.insert(readU16(gsub, set + readU16(gsub, set + 2 + j * 2)));
+        }
+        break;
+    }
+    case 7: { //extension
+        int extensionType = readU16(gsub, subtable + 2);
+        if (extensionType != 7)
+            addSubstitutes(gsub, extensionType, subtable + readU32(gsub, subtable + 4), glyphs);
+        break;
+    }
+    case 8: { //reverse chaining single
+        int offset = subtable + 4;
+        offset += 2 + readU16(gsub, offset) * 2;
+        offset += 2 + readU16(gsub, offset) * 2;
+        int count = readU16(gsub, offset);
+        for(int i=0; i < count; i++)
+            glyphs.insert(readU16(gsub, offset + 2 + i * 2));
+        break;
+    }
+    default:
+        //contextual lookups only apply other lookups, which are all visited
+        break;
+    }
+}
+
+//Every glyph a GSUB lookup can output. Which of them the text can actually reach depends
+//on the shaping done by the browser, so they're all kept.
+QSet<quint16> FontSubsetter::substitutes() const
+{
+    QSet<quint16> glyphs;
+    QByteArray gsub = mTables.value("GSUB");
+    if (gsub.size() < 10)
+        return glyphs;
+
+    int lookupList = readU16(gsub, 8);
+    int lookupCount = readU16(gsub, lookupList);
+    for(int i=0; i < lookupCount; i++) {
+        int lookup = lookupList + readU16(gsub, lookupList + 2 + i * 2);
+        int type = readU16(gsub, lookup);
+        int subtableCount = readU16(gsub, lookup + 4);
+        for(int j=0; j < subtableCount; j++)
+            addSubstitutes(gsub, type, lookup + readU16(gsub, lookup + 6 + j * 2), glyphs);
+    }
+
+    return glyphs;
+}
+
+void FontSubsetter::addComponents(const QByteArray& glyph, QSet<quint16>& components) const
+{
+    //simple glyphs have a positive number of contours
+    if (glyph.size() < 10 || qint16(readU16(glyph, 0)) >= 0)
+        return;
+
+    int offset = 10;
+    quint16 flags = MORE_COMPONENTS;
+    while((flags & MORE_COMPONENTS) && offset + 4 <= glyph.size()) {
+        flags = readU16(glyph, offset);
+        components.insert(readU16(glyph, offset + 2));
+        offset += 4;
+        offset += (flags & ARG_1_AND_2_ARE_WORDS) ? 4 : 2;
+        if (flags & WE_HAVE_A_SCALE)
+            offset += 2;
+        else if (flags & WE_HAVE_AN_X_AND_Y_SCALE)
+            offset += 4;
+        else if (flags & WE_HAVE_A_TWO_BY_TWO)
+            offset += 8;
+    }
+}
+
+QByteArray FontSubsetter::subset(const QByteArray& data, const QString& text)
+{
+    FontSubsetter subsetter;
+    if (! subsetter.load(data))
+        return QByteArray();
+
+    QSet<uint> characters;
+    foreach(uint character, text.toUcs4())
+        characters.insert(character);
+
+    if (! subsetter.subset(characters))
+        return QByteArray();
+
+    QByteArray subset = subsetter.data();
+    if (subset.size() >= data.size())
+        return QByteArray();
+    return subset;
+}
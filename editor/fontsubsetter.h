@@ -0,0 +1,39 @@
+#ifndef FONTSUBSETTER_H
+#define FONTSUBSETTER_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QSet>
+#include <QString>
+
+//Removes the outlines of the glyphs that aren't needed from TrueType and WOFF fonts.
+//Glyph ids are kept, so cmap, hmtx and the layout tables stay valid without being rewritten.
+//Fonts with CFF outlines (and anything else it can't parse) are not supported.
+class FontSubsetter
+{
+    QMap<QByteArray, QByteArray> mTables;
+    quint32 mFlavor;
+    bool mWoff;
+
+public:
+    FontSubsetter();
+    virtual ~FontSubsetter();
+
+    bool load(const QByteArray&);
+    bool subset(const QSet<uint>&);
+    QByteArray data() const;
+    bool isWoff() const;
+
+    static QByteArray subset(const QByteArray&, const QString& text);
+
+private:
+    bool loadSfnt(const QByteArray&);
+    bool loadWoff(const QByteArray&);
+    QByteArray toSfnt() const;
+    QByteArray toWoff() const;
+    quint16 glyphIndex(uint) const;
+    QSet<quint16> substitutes() const;
+    void addComponents(const QByteArray&, QSet<quint16>&) const;
+};
+
+#endif // FONTSUBSETTER_H
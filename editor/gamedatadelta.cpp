@@ -0,0 +1,100 @@
+#include "gamedatadelta.h"
+
+#include <QHash>
+
+#include "dependencyanalyzer.h"
+
+//Returns an empty map when nothing changed and {"reload": true} when the preview has to reload
+QVariantMap GameDataDelta::diff(const QVariantMap& before, const QVariantMap& after, const QStringList& assetNames)
+{
+    QVariantMap delta;
+    QSet<QString> keys = before.keys().toSet() + after.keys().toSet();
+    keys.remove("scenes");
+    keys.remove("pauseScreen");
+    keys.remove("resources");
+
+    foreach(const QString& key, keys) {
+        if (before.value(key) != after.value(key)) {
+            delta.insert("reload", true);
+            return delta;
+        }
+    }
+
+    QVariantMap resourcesBefore = before.value("resources").toMap();
+    QVariantMap resourcesAfter = after.value("resources").toMap();
+    QVariantMap resources;
+    QStringList removedResources;
+    foreach(const QString& name, resourcesAfter.keys()) {
+        if (resourcesBefore.value(name) != resourcesAfter.value(name))
+            resources.insert(name, resourcesAfter.value(name));
+    }
+    foreach(const QString& name, resourcesBefore.keys()) {
+        if (! resourcesAfter.contains(name))
+            removedResources.append(name);
+    }
+
+    //scenes using a changed resource are replaced too, so they pick up the new one
+    QSet<QString> changedResources = resources.keys().toSet() + removedResources.toSet();
+    DependencyAnalyzer analyzer(after, assetNames);
+
+    QVariantList scenesBefore = before.value("scenes").toList();
+    QVariantList scenesAfter = after.value("scenes").toList();
+    QVariantList scenes = changedScenes(scenesBefore, scenesAfter, changedResources, analyzer, false);
+    bool reordered = sceneNames(scenesBefore) != sceneNames(scenesAfter);
+
+    QVariantList pauseScenesBefore = before.value("pauseScreen").toMap().value("scenes").toList();
+    QVariantList pauseScenesAfter = after.value("pauseScreen").toMap().value("scenes").toList();
+    QVariantList pauseScenes = changedScenes(pauseScenesBefore, pauseScenesAfter, changedResources, analyzer, true);
+    bool pauseReordered = sceneNames(pauseScenesBefore) != sceneNames(pauseScenesAfter);
+
+    if (! resources.isEmpty())
+        delta.insert("resources", resources);
+    if (! removedResources.isEmpty())
+        delta.insert("removedResources", removedResources);
+    if (! scenes.isEmpty())
+        delta.insert("scenes", scenes);
+    if (reordered)
+        delta.insert("sceneOrder", sceneNames(scenesAfter));
+    if (! pauseScenes.isEmpty())
+        delta.insert("pauseScenes", pauseScenes);
+    if (pauseReordered)
+        delta.insert("pauseSceneOrder", sceneNames(pauseScenesAfter));
+
+    //what each scene needs may have changed, so the preview knows what to fetch
+    if (! delta.isEmpty()) {
+        QVariantMap manifests = analyzer.manifests();
+        foreach(const QString& key, manifests.keys())
+            delta.insert(key, manifests.value(key));
+    }
+
+    return delta;
+}
+
+QVariantList GameDataDelta::changedScenes(const QVariantList& before, const QVariantList& after, const QSet<QString>& resources,
+                                          const DependencyAnalyzer& analyzer, bool pause)
+{
+    QHash<QString, QVariant> previous;
+    foreach(const QVariant& scene, before)
+        previous.insert(scene.toMap().value("name").toString(), scene);
+
+    //the pause screen's resources aren't kept per scene
+    bool pauseResourcesChanged = pause && ! analyzer.pauseScreenResources().toSet().intersect(resources).isEmpty();
+
+    QVariantList changed;
+    foreach(const QVariant& scene, after) {
+        QString name = scene.toMap().value("name").toString();
+        bool usesChangedResource = pause ? pauseResourcesChanged : ! analyzer.sceneResources(name).toSet().intersect(resources).isEmpty();
+        if (usesChangedResource || ! previous.contains(name) || previous.value(name) != scene)
+            changed.append(scene);
+    }
+
+    return changed;
+}
+
+QStringList GameDataDelta::sceneNames(const QVariantList& scenes)
+{
+    QStringList names;
+    foreach(const QVariant& scene, scenes)
+        names.append(scene.toMap().value("name").toString());
+    return names;
+}
@@ -0,0 +1,22 @@
+#ifndef GAMEDATADELTA_H
+#define GAMEDATADELTA_H
+
+#include <QSet>
+#include <QStringList>
+#include <QVariantMap>
+
+class DependencyAnalyzer;
+
+//Changes between two versions of the exported game data, sent to a running preview so it can
+//patch itself. Scenes are replaced as a whole; changed game properties need a full reload.
+class GameDataDelta
+{
+public:
+    static QVariantMap diff(const QVariantMap& before, const QVariantMap& after, const QStringList& assetNames);
+
+private:
+    static QVariantList changedScenes(const QVariantList&, const QVariantList&, const QSet<QString>& resources, const DependencyAnalyzer&, bool pause);
+    static QStringList sceneNames(const QVariantList&);
+};
+
+#endif // GAMEDATADELTA_H
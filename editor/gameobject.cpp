@@ -3,6 +3,40 @@
 #include "scene.h"
 #include "resource_manager.h"
 
+//Changes for different objects of a group can't be merged
+static bool canMergeChanges(const QVariantMap& changes, const QVariantMap& data)
+{
+    if (changes.contains("_index") && data.contains("_index") && changes.value("_index") != data.value("_index"))
+        return false;
+
+    QMapIterator<QString, QVariant> it(data);
+    while(it.hasNext()) {
+        it.next();
+        QVariant value = changes.value(it.key());
+        if (value.type() == QVariant::Map && it.value().type() == QVariant::Map && ! canMergeChanges(value.toMap(), it.value().toMap()))
+            return false;
+    }
+
+    return true;
+}
+
+//Later values replace earlier ones, partial maps (like the font) are merged
+static void mergeChanges(QVariantMap& changes, const QVariantMap& data)
+{
+    QMapIterator<QString, QVariant> it(data);
+    while(it.hasNext()) {
+        it.next();
+        QVariant value = changes.value(it.key());
+        if (value.type() == QVariant::Map && it.value().type() == QVariant::Map) {
+            QVariantMap map = value.toMap();
+            mergeChanges(map, it.value().toMap());
+            changes.insert(it.key(), map);
+        }
+        else
+            changes.insert(it.key(), it.value());
+    }
+}
+
 GameObject::GameObject(QObject *parent, const QString& name) :
     QObject(parent)
 {
@@ -30,6 +64,11 @@ void GameObject::init()
     mType = GameObjectMetaType::GameObject;
     mManager = 0;
     mLoadBlocked = false;
+    mBatchDepth = 0;
+    mHasPendingChanges = false;
+    connect(this, SIGNAL(dataChanged(const QVariantMap&)), this, SLOT(invalidateSceneCache(const QVariantMap&)));
+    connect(this, SIGNAL(nameChanged(const QString&)), this, SLOT(invalidateSceneCache()));
+    connect(this, SIGNAL(syncChanged(bool)), this, SLOT(invalidateSceneCache()));
 }
 
 void GameObject::load(const QVariantMap & data)
@@ -47,6 +86,20 @@ void GameObject::load(const QVariantMap & data)
     loadData(_data);
     afterLoadData(_data);
     blockNotifications(false);
+    //loading doesn't notify, but it still changes what's saved
+    invalidateSceneCache();
+}
+
+//Like load() but the object reports the changes it goes through, e.g. when they're undone
+void GameObject::apply(const QVariantMap & data)
+{
+    if (mLoadBlocked || data.isEmpty())
+        return;
+
+    ChangeBatch batch(this);
+    beforeLoadData(data);
+    loadData(data);
+    afterLoadData(data);
 }
 
 void GameObject::loadInternal(const QVariantMap & data)
@@ -156,6 +209,7 @@ void GameObject::setResource(GameObject * resource)
         if (mSynced)
             connectToResource();
     }
+    invalidateSceneCache();
 }
 
 GameObject* GameObject::resource() const
@@ -166,6 +220,7 @@ GameObject* GameObject::resource() const
 void GameObject::resourceDestroyed()
 {
     mResource = 0;
+    invalidateSceneCache();
 }
 
 void GameObject::addClone(GameObject * clone)
@@ -265,6 +320,27 @@ Scene * GameObject::scene() const
     return 0;
 }
 
+//Objects are saved as part of their scene, which keeps them serialized until something in it changes.
+//Clones are saved as differences from their resource, so changing a resource can affect any scene.
+void GameObject::invalidateSceneCache()
+{
+    if (isResource()) {
+        Scene::invalidateAllCaches();
+        return;
+    }
+
+    Scene* scene = this->scene();
+    if (scene)
+        scene->invalidateCache();
+}
+
+//dataChanged() without changes only asks for a repaint, e.g. on every frame of an animation
+void GameObject::invalidateSceneCache(const QVariantMap& data)
+{
+    if (! data.isEmpty())
+        invalidateSceneCache();
+}
+
 void GameObject::notify(const QString & property, const QVariant & value)
 {
     QVariantMap data;
@@ -274,11 +350,50 @@ void GameObject::notify(const QString & property, const QVariant & value)
 
 void GameObject::notify(const QVariantMap & data)
 {
+    if (mBatchDepth > 0) {
+        //it wouldn't have been sent anyway, e.g. while loading
+        if (signalsBlocked())
+            return;
+        if (mHasPendingChanges && ! canMergeChanges(mPendingChanges, data)) {
+            QVariantMap changes = mPendingChanges;
+            mPendingChanges = data;
+            bool loadBlocked = blockLoad(true);
+            emit dataChanged(changes);
+            blockLoad(loadBlocked);
+        }
+        else
+            mergeChanges(mPendingChanges, data);
+        mHasPendingChanges = true;
+        return;
+    }
+
     bool loadBlocked = blockLoad(true);
     emit dataChanged(data);
     blockLoad(loadBlocked);
 }
 
+//Notifications are held back until the matching endChanges() and then sent as one; calls can be nested
+void GameObject::beginChanges()
+{
+    mBatchDepth++;
+}
+
+void GameObject::endChanges()
+{
+    if (mBatchDepth == 0 || --mBatchDepth > 0 || ! mHasPendingChanges)
+        return;
+
+    QVariantMap changes = mPendingChanges;
+    mPendingChanges.clear();
+    mHasPendingChanges = false;
+    notify(changes);
+}
+
+bool GameObject::isBatchingChanges() const
+{
+    return mBatchDepth > 0;
+}
+
 GameObjectManager* GameObject::manager() const
 {
     return mManager;
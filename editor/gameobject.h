@@ -2,6 +2,7 @@
 #define GAMEOBJECT_H
 
 #include <QObject>
+#include <QPointer>
 #include <QVariantMap>
 
 #include "gameobjectmetatype.h"
@@ -39,6 +40,10 @@ public:
     bool loadBlocked() const;
     bool blockNotifications(bool);
 
+    void beginChanges();
+    void endChanges();
+    bool isBatchingChanges() const;
+
     void sync();
     bool isSynced() const;
 
@@ -49,10 +54,15 @@ public:
 
 public slots:
     void load(const QVariantMap&);
+    void apply(const QVariantMap&);
     void removeClone(GameObject*);
     bool setName(const QString&);
     void setSync(bool);
 
+protected slots:
+    void invalidateSceneCache();
+    void invalidateSceneCache(const QVariantMap&);
+
 private slots:
     void resourceDestroyed();
 
@@ -80,6 +90,9 @@ private:
     QList<GameObject*> mClones;
     GameObjectManager* mManager;
     bool mLoadBlocked;
+    int mBatchDepth;
+    QVariantMap mPendingChanges;
+    bool mHasPendingChanges;
 
 signals:
     void destroyed(GameObject*);
@@ -91,4 +104,14 @@ public slots:
 
 };
 
+//Merges the notifications an object sends while it's in scope into one, sent when it goes out of scope
+class ChangeBatch
+{
+    QPointer<GameObject> mObject;
+
+public:
+    explicit ChangeBatch(GameObject* object) : mObject(object) { if (mObject) mObject->beginChanges(); }
+    ~ChangeBatch() { if (mObject) mObject->endChanges(); }
+};
+
 #endif // GAMEOBJECT_H
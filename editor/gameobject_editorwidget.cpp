@@ -1,5 +1,7 @@
 #include "gameobject_editorwidget.h"
 
+#include "undohistory.h"
+
 GameObjectEditorWidget::GameObjectEditorWidget(QWidget *parent) :
     PropertiesWidget(parent)
 {
@@ -36,6 +38,9 @@ void GameObjectEditorWidget::onGameObjectDestroyed()
 
 void GameObjectEditorWidget::setGameObject(GameObject * object)
 {
+    //the object being edited is the one whose changes can be undone
+    UndoHistory::instance()->track(object);
+
     if (object == mGameObject) {
         reload();
         return;
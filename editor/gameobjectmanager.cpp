@@ -71,6 +71,7 @@ GameObject* GameObjectManager::takeAt(int index)
     if (index < 0 || index >= mGameObjects.size())
         return 0;
 
+    emit objectAboutToBeTaken(index, mGameObjects.at(index));
     GameObject* obj = mGameObjects.takeAt(index);
     if (obj)
         obj->disconnect(this);
@@ -128,6 +129,7 @@ bool GameObjectManager::move(GameObject* obj, int to)
     insert(to, obj);
     blockSignals(blocked);
     emit objectMoved(obj, to);
+    emit objectMoved(obj, from, to);
     return true;
 }
 
@@ -63,10 +63,12 @@ private:
 signals:
     void objectAdded(GameObject*);
     void objectInserted(int, GameObject*);
+    void objectAboutToBeTaken(int, GameObject*);
     void objectTaken(GameObject*);
     void objectRemoved(GameObject*, bool del=false);
     void objectChanged();
     void objectMoved(GameObject*, int);
+    void objectMoved(GameObject*, int, int);
 
 private slots:
     void onObjectDestroyed(GameObject*);
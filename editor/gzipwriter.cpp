@@ -0,0 +1,80 @@
+#include "gzipwriter.h"
+
+#include <QFile>
+#include <QSaveFile>
+
+static void appendLittleEndian(QByteArray& data, quint32 value)
+{
+    for(int i=0; i < 4; i++)
+        data.append(char((value >> (i*8)) & 0xff));
+}
+
+//built before main, so compressing from several threads is safe
+struct Crc32Table
+{
+    quint32 values[256];
+    Crc32Table()
+    {
+        for(quint32 i=0; i < 256; i++) {
+            quint32 c = i;
+            for(int k=0; k < 8; k++)
+                c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+            values[i] = c;
+        }
+    }
+};
+
+static const Crc32Table crcTable;
+
+quint32 GzipWriter::crc32(const QByteArray& data)
+{
+    quint32 crc = 0xffffffff;
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+    for(int i=0; i < data.size(); i++)
+        crc = crcTable.values[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffff;
+}
+
+//qCompress returns the uncompressed size (4 bytes), a zlib header (2 bytes),
+//the deflate stream and an adler32 checksum (4 bytes); gzip only keeps the stream.
+QByteArray GzipWriter::compress(const QByteArray& data, int level)
+{
+    QByteArray zlib = qCompress(data, level);
+    if (zlib.size() < 10)
+        return QByteArray();
+
+    QByteArray gzip;
+    gzip.reserve(zlib.size() + 8);
+    gzip.append("\x1f\x8b\x08\x00", 4); //magic, deflate, no flags
+    appendLittleEndian(gzip, 0); //no modification time
+    gzip.append(char(level >= 9 ? 2 : 0));
+    gzip.append(char(0xff)); //unknown OS
+    gzip.append(zlib.constData() + 6, zlib.size() - 10);
+    appendLittleEndian(gzip, crc32(data));
+    appendLittleEndian(gzip, quint32(data.size()));
+    return gzip;
+}
+
+//The file is only written when it's smaller than the original
+bool GzipWriter::compressFile(const QString& path, const QString& _destination)
+{
+    QString destination = _destination.isEmpty() ? path + ".gz" : _destination;
+    QFile file(path);
+    if (! file.open(QFile::ReadOnly))
+        return false;
+
+    QByteArray data = file.readAll();
+    file.close();
+
+    QByteArray compressed = compress(data);
+    if (compressed.isEmpty() || compressed.size() >= data.size()) {
+        QFile::remove(destination);
+        return false;
+    }
+
+    QSaveFile output(destination);
+    if (! output.open(QFile::WriteOnly))
+        return false;
+    output.write(compressed);
+    return output.commit();
+}
@@ -0,0 +1,16 @@
+#ifndef GZIPWRITER_H
+#define GZIPWRITER_H
+
+#include <QByteArray>
+#include <QString>
+
+//Writes gzip files with the deflate stream from qCompress, so no extra zlib dependency is needed.
+class GzipWriter
+{
+public:
+    static QByteArray compress(const QByteArray&, int level=9);
+    static bool compressFile(const QString&, const QString& destination=QString());
+    static quint32 crc32(const QByteArray&);
+};
+
+#endif // GZIPWRITER_H
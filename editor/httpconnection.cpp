@@ -0,0 +1,160 @@
+#include "httpconnection.h"
+
+#include "simple_http_server.h"
+
+#define STREAM_CHUNK_SIZE 65536
+
+HttpConnection::HttpConnection(qintptr socketDescriptor, SimpleHttpServer* server) :
+    QObject(0)
+{
+    mSocketDescriptor = socketDescriptor;
+    mServer = server;
+    mSocket = 0;
+    mIdleTimer = 0;
+    mStreamRemaining = 0;
+    mClosing = false;
+    mEventStream = false;
+}
+
+HttpConnection::~HttpConnection()
+{
+    if (mEventStream)
+        mServer->addSubscribers(-1);
+}
+
+void HttpConnection::start()
+{
+    mSocket = new QTcpSocket(this);
+    if (! mSocket->setSocketDescriptor(mSocketDescriptor)) {
+        deleteLater();
+        return;
+    }
+
+    mIdleTimer = new QTimer(this);
+    mIdleTimer->setSingleShot(true);
+    mIdleTimer->setInterval(KEEP_ALIVE_TIMEOUT * 1000);
+
+    connect(mSocket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+    connect(mSocket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
+    connect(mSocket, SIGNAL(disconnected()), this, SLOT(deleteLater()));
+    connect(mIdleTimer, SIGNAL(timeout()), this, SLOT(close()));
+    mIdleTimer->start();
+
+    //data may have arrived before the socket was set up
+    if (mSocket->bytesAvailable())
+        onReadyRead();
+}
+
+void HttpConnection::close()
+{
+    if (mSocket)
+        mSocket->disconnectFromHost();
+    else
+        deleteLater();
+}
+
+bool HttpConnection::isStreaming() const
+{
+    return mStreamFile.isOpen();
+}
+
+void HttpConnection::onReadyRead()
+{
+    mIdleTimer->stop();
+    //requests parsed before any invalid data are still answered
+    mParser.feed(mSocket->readAll());
+    processRequests();
+}
+
+void HttpConnection::processRequests()
+{
+    while(! mClosing && ! mEventStream && ! isStreaming() && mParser.hasRequest()) {
+        HttpRequest request = mParser.takeRequest();
+        HttpResponse response = mServer->respond(request);
+        mSocket->write(response.headerData());
+        if (! response.body.isEmpty())
+            mSocket->write(response.body);
+
+        if (! response.keepAlive)
+            mClosing = true;
+
+        //event streams only receive events from now on
+        if (response.eventStream) {
+            mEventStream = true;
+            mServer->addSubscribers(1);
+            connect(mServer, SIGNAL(eventPublished(const QString&, const QByteArray&)), this, SLOT(sendEvent(const QString&, const QByteArray&)));
+        }
+
+        if (! response.filePath.isEmpty()) {
+            mStreamFile.setFileName(response.filePath);
+            if (mStreamFile.open(QFile::ReadOnly) && mStreamFile.seek(response.fileOffset)) {
+                mStreamRemaining = response.fileLength;
+                streamChunk();
+            }
+            else {
+                //the headers are out already, so the only way to signal the error is closing
+                mStreamFile.close();
+                mClosing = true;
+            }
+        }
+    }
+
+    if (isStreaming() || mEventStream)
+        return;
+
+    if (mClosing)
+        mSocket->disconnectFromHost();
+    else if (mParser.hasError())
+        sendError(400, "Bad Request");
+    else
+        mIdleTimer->start();
+}
+
+void HttpConnection::onBytesWritten(qint64)
+{
+    if (isStreaming() && mSocket->bytesToWrite() < STREAM_CHUNK_SIZE)
+        streamChunk();
+}
+
+void HttpConnection::streamChunk()
+{
+    if (mStreamRemaining > 0) {
+        QByteArray data = mStreamFile.read(qMin(mStreamRemaining, qint64(STREAM_CHUNK_SIZE)));
+        if (data.isEmpty()) {
+            //file shrunk while sending it
+            mStreamRemaining = 0;
+            mClosing = true;
+        }
+        else {
+            mStreamRemaining -= data.size();
+            mSocket->write(data);
+        }
+    }
+
+    if (mStreamRemaining <= 0) {
+        mStreamFile.close();
+        //continue with the pipelined requests
+        processRequests();
+    }
+}
+
+void HttpConnection::sendEvent(const QString& event, const QByteArray& data)
+{
+    QByteArray message = "event: " + event.toUtf8() + "\n";
+    foreach(const QByteArray& line, data.split('\n'))
+        message += "data: " + line + "\n";
+    message += "\n";
+    mSocket->write(message);
+}
+
+void HttpConnection::sendError(int status, const QString& reason)
+{
+    HttpResponse response;
+    response.status = status;
+    response.reason = reason;
+    response.keepAlive = false;
+    response.headers << "Content-Length: 0";
+    mSocket->write(response.headerData());
+    mClosing = true;
+    mSocket->disconnectFromHost();
+}
@@ -0,0 +1,49 @@
+#ifndef HTTPCONNECTION_H
+#define HTTPCONNECTION_H
+
+#include <QObject>
+#include <QFile>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include "httprequestparser.h"
+
+class SimpleHttpServer;
+
+//Lives in one of the server's worker threads. Pipelined requests are answered in order,
+//one at a time, and big files are written in chunks as the socket drains.
+class HttpConnection : public QObject
+{
+    Q_OBJECT
+
+    qintptr mSocketDescriptor;
+    SimpleHttpServer* mServer;
+    QTcpSocket* mSocket;
+    QTimer* mIdleTimer;
+    HttpRequestParser mParser;
+    QFile mStreamFile;
+    qint64 mStreamRemaining;
+    bool mClosing;
+    bool mEventStream;
+
+public:
+    HttpConnection(qintptr socketDescriptor, SimpleHttpServer* server);
+    virtual ~HttpConnection();
+
+public slots:
+    void start();
+    void close();
+
+private slots:
+    void onReadyRead();
+    void onBytesWritten(qint64);
+    void processRequests();
+    void sendEvent(const QString&, const QByteArray&);
+
+private:
+    bool isStreaming() const;
+    void streamChunk();
+    void sendError(int, const QString&);
+};
+
+#endif // HTTPCONNECTION_H
@@ -0,0 +1,164 @@
+#include "httprequestparser.h"
+
+#include <QStringList>
+
+QString HttpRequest::header(const QString& name) const
+{
+    return headers.value(name.toLower());
+}
+
+//HTTP/1.1 keeps connections open unless told otherwise, HTTP/1.0 only when asked to
+bool HttpRequest::keepAlive() const
+{
+    QString connection = header("connection").toLower();
+    if (version == "HTTP/1.0")
+        return connection.contains("keep-alive");
+    return ! connection.contains("close");
+}
+
+HttpRequestParser::HttpRequestParser()
+{
+    reset();
+}
+
+HttpRequestParser::~HttpRequestParser()
+{
+}
+
+void HttpRequestParser::reset()
+{
+    mBuffer.clear();
+    mState = RequestLine;
+    mRequest = HttpRequest();
+    mHeaderSize = 0;
+    mContentLength = 0;
+    mRequests.clear();
+    mError = false;
+}
+
+//Returns false once the data isn't valid HTTP, the connection should be closed then
+bool HttpRequestParser::feed(const QByteArray& data)
+{
+    if (mError)
+        return false;
+
+    mBuffer.append(data);
+
+    while(! mError) {
+        if (mState == Body) {
+            if (mBuffer.size() < mContentLength)
+                break;
+            mRequest.body = mBuffer.left(mContentLength);
+            mBuffer.remove(0, mContentLength);
+            finishRequest();
+            continue;
+        }
+
+        int end = mBuffer.indexOf('\n');
+        if (end == -1) {
+            if (mHeaderSize + mBuffer.size() > HTTP_MAX_HEADER_SIZE)
+                mError = true;
+            break;
+        }
+
+        QByteArray line = mBuffer.left(end);
+        mBuffer.remove(0, end+1);
+        mHeaderSize += end+1;
+        if (line.endsWith('\r'))
+            line.chop(1);
+
+        if (mHeaderSize > HTTP_MAX_HEADER_SIZE || ! parseLine(line))
+            mError = true;
+    }
+
+    return ! mError;
+}
+
+bool HttpRequestParser::parseLine(const QByteArray& line)
+{
+    if (mState == RequestLine) {
+        //empty lines between requests are allowed
+        if (line.isEmpty()) {
+            mHeaderSize = 0;
+            return true;
+        }
+        return parseRequestLine(QString::fromLatin1(line));
+    }
+
+    if (line.isEmpty())
+        return finishHeaders();
+
+    return parseHeader(QString::fromLatin1(line));
+}
+
+bool HttpRequestParser::parseRequestLine(const QString& line)
+{
+    QStringList parts = line.split(' ', QString::SkipEmptyParts);
+    if (parts.size() != 3 || ! parts[2].startsWith("HTTP/"))
+        return false;
+
+    mRequest.method = parts[0];
+    mRequest.target = parts[1];
+    mRequest.version = parts[2];
+    mState = Headers;
+    return true;
+}
+
+bool HttpRequestParser::parseHeader(const QString& line)
+{
+    //values can have colons too (e.g. "Host: 127.0.0.1:8000")
+    int colon = line.indexOf(':');
+    if (colon <= 0)
+        return false;
+
+    QString name = line.left(colon).trimmed().toLower();
+    QString value = line.mid(colon+1).trimmed();
+    if (mRequest.headers.contains(name))
+        value = mRequest.headers.value(name) + ", " + value;
+    mRequest.headers.insert(name, value);
+    return true;
+}
+
+bool HttpRequestParser::finishHeaders()
+{
+    //the preview never needs chunked request bodies
+    if (mRequest.headers.contains("transfer-encoding"))
+        return false;
+
+    bool ok = true;
+    mContentLength = mRequest.headers.value("content-length", "0").toInt(&ok);
+    if (! ok || mContentLength < 0 || mContentLength > HTTP_MAX_BODY_SIZE)
+        return false;
+
+    if (mContentLength > 0)
+        mState = Body;
+    else
+        finishRequest();
+    return true;
+}
+
+void HttpRequestParser::finishRequest()
+{
+    mRequests.append(mRequest);
+    mRequest = HttpRequest();
+    mState = RequestLine;
+    mHeaderSize = 0;
+    mContentLength = 0;
+}
+
+bool HttpRequestParser::hasRequest() const
+{
+    return ! mRequests.isEmpty();
+}
+
+HttpRequest HttpRequestParser::takeRequest()
+{
+    if (mRequests.isEmpty())
+        return HttpRequest();
+    return mRequests.takeFirst();
+}
+
+bool HttpRequestParser::hasError() const
+{
+    return mError;
+}
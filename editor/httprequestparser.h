@@ -0,0 +1,60 @@
+#ifndef HTTPREQUESTPARSER_H
+#define HTTPREQUESTPARSER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#define HTTP_MAX_HEADER_SIZE 65536
+#define HTTP_MAX_BODY_SIZE 1048576
+
+struct HttpRequest
+{
+    QString method;
+    QString target;
+    QString version;
+    QHash<QString, QString> headers; //names in lower case
+    QByteArray body;
+
+    QString header(const QString&) const;
+    bool keepAlive() const;
+};
+
+//Requests can arrive split over several reads, or several of them in one read (pipelining),
+//so data is buffered and complete requests are queued in the order they arrived.
+class HttpRequestParser
+{
+    enum State {
+        RequestLine,
+        Headers,
+        Body
+    };
+
+    QByteArray mBuffer;
+    State mState;
+    HttpRequest mRequest;
+    int mHeaderSize;
+    int mContentLength;
+    QList<HttpRequest> mRequests;
+    bool mError;
+
+public:
+    HttpRequestParser();
+    virtual ~HttpRequestParser();
+
+    bool feed(const QByteArray&);
+    bool hasRequest() const;
+    HttpRequest takeRequest();
+    bool hasError() const;
+    void reset();
+
+private:
+    bool parseLine(const QByteArray&);
+    bool parseRequestLine(const QString&);
+    bool parseHeader(const QString&);
+    bool finishHeaders();
+    void finishRequest();
+};
+
+#endif // HTTPREQUESTPARSER_H
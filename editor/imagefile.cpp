@@ -15,6 +15,15 @@ ImageFile::ImageFile(const QString&path, bool load) :
     mTransparent = false;
 }
 
+//image already decoded, possibly in another thread
+ImageFile::ImageFile(const QString& path, const QImage& image) :
+    Asset(path, Asset::Image)
+{
+    mPixmap = QPixmap::fromImage(image);
+    mPath = path;
+    mTransparent = false;
+}
+
 ImageFile::~ImageFile()
 {
 }
@@ -82,11 +91,14 @@ bool ImageFile::isAnimated(const QString& path)
     return animated;
 }
 
-ImageFile* ImageFile::create(const QString& path)
+ImageFile* ImageFile::create(const QString& path, const QImage& image)
 {
     if (ImageFile::isAnimated(path))
         return new AnimatedImage(path);
 
+    if (! image.isNull())
+        return new ImageFile(path, image);
+
     return new ImageFile(path);
 }
 
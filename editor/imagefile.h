@@ -3,6 +3,7 @@
 
 #include <QString>
 #include <QPixmap>
+#include <QImage>
 #include <QMovie>
 
 #include "asset.h"
@@ -11,6 +12,7 @@ class ImageFile : public Asset
 {
 public:
     ImageFile(const QString&, bool load=true);
+    ImageFile(const QString&, const QImage&);
     virtual ~ImageFile();
 
     virtual bool isAnimated() const;
@@ -23,7 +25,7 @@ public:
     virtual bool isNull() const;
 
     static bool isAnimated(const QString&);
-    static ImageFile* create(const QString&);
+    static ImageFile* create(const QString&, const QImage& image=QImage());
     static bool isTransparent(const QImage&);
     static QStringList supportedFormats();
 
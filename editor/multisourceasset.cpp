@@ -1,5 +1,7 @@
 #include "multisourceasset.h"
 
+#include <QCryptographicHash>
+
 #include "assetmanager.h"
 
 MultiSourceAsset::MultiSourceAsset(MultiSourceAsset::Type type) :
@@ -194,6 +196,23 @@ QVariantMap MultiSourceAsset::toJsonObject()
     return data;
 }
 
+QByteArray MultiSourceAsset::contentHash() const
+{
+    if (mSources.isEmpty())
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    foreach(Asset* src, mSources) {
+        QByteArray srcHash = src->contentHash();
+        if (srcHash.isEmpty())
+            return QByteArray();
+        hash.addData(srcHash);
+    }
+
+    return hash.result();
+}
+
 void MultiSourceAsset::sourceRemoved(Asset * asset)
 {
 }
@@ -30,6 +30,7 @@ public:
     bool containsSource(const QString&);
     Asset* source(const QString&);
     virtual QVariantMap toJsonObject();
+    virtual QByteArray contentHash() const;
 
 protected:
     virtual bool doSave(const QDir&);
@@ -43,6 +43,9 @@ NovelPropertiesDialog::NovelPropertiesDialog(QVariantMap& data, QWidget *parent)
     mUi.browserEdit->setText(Engine::browserPath());
     mUi.browserEdit->setPlaceholderText("Default");
     mUi.checkBuiltinBrowser->setChecked(Engine::useBuiltinBrowser());
+    mUi.imageQualitySpinner->setValue(data.value("imageQuality").toInt());
+    mUi.imageFormatCombo->setCurrentIndex(data.value("imageFormat").toString() == "webp" ? 1 : 0);
+    mUi.compressExportCheckBox->setChecked(data.value("compressExport").toBool());
 
     connect(mUi.widthCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(onWidthChanged(int)));
     connect(mUi.widthCombo, SIGNAL(editTextChanged(const QString&)), this, SLOT(onSizeEdited(const QString&)));
@@ -56,6 +59,9 @@ NovelPropertiesDialog::NovelPropertiesDialog(QVariantMap& data, QWidget *parent)
     connect(mUi.engineDirectoryButton, SIGNAL(clicked()), this, SLOT(onEnginePathChangeRequest()));
     connect(mUi.browserButton, SIGNAL(clicked()), this, SLOT(onBrowserSelect()));
     connect(mUi.textSpeedSlider, SIGNAL(valueChanged(int)), this, SLOT(onTextSpeedChanged(int)));
+    connect(mUi.imageQualitySpinner, SIGNAL(valueChanged(int)), this, SLOT(onImageQualityChanged(int)));
+    connect(mUi.imageFormatCombo, SIGNAL(currentIndexChanged(int)), this, SLOT(onImageFormatChanged(int)));
+    connect(mUi.compressExportCheckBox, SIGNAL(toggled(bool)), this, SLOT(onCompressExportToggled(bool)));
 }
 
 void NovelPropertiesDialog::onWidthChanged(int index)
@@ -174,6 +180,21 @@ void NovelPropertiesDialog::onTextSpeedChanged(int value)
     mNovelData.insert("textSpeed", value);
 }
 
+void NovelPropertiesDialog::onImageQualityChanged(int value)
+{
+    mNovelData.insert("imageQuality", value);
+}
+
+void NovelPropertiesDialog::onImageFormatChanged(int index)
+{
+    mNovelData.insert("imageFormat", index == 1 ? "webp" : "jpg");
+}
+
+void NovelPropertiesDialog::onCompressExportToggled(bool compress)
+{
+    mNovelData.insert("compressExport", compress);
+}
+
 bool NovelPropertiesDialog::useBuiltinBrowser()
 {
     return mUi.checkBuiltinBrowser->isChecked();
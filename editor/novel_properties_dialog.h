@@ -48,6 +48,9 @@ public slots:
     void updateTextSpeedSliderTooltip(int);
     void onBrowserSelect();
     void onTextSpeedChanged(int);
+    void onImageQualityChanged(int);
+    void onImageFormatChanged(int);
+    void onCompressExportToggled(bool);
 
 private:
     Ui::NovelPropertiesDialog mUi;
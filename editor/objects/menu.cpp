@@ -150,6 +150,8 @@ void Menu::setNumberOfOptions(int number)
     if (number == options().size())
         return;
 
+    //send a single "objects" notification instead of one per option
+    ChangeBatch batch(this);
     for(int i=objects().size(); i < number; i++)
         addOption(QString("%1 %2").arg("Button").arg(QString::number(i+1)));
 
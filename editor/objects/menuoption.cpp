@@ -104,6 +104,7 @@ void MenuOption::addAction(Action* action)
         return;
 
     mActionManager->add(action);
+    invalidateSceneCache();
     emit dataChanged();
 }
 
@@ -113,6 +114,7 @@ void MenuOption::removeActionAt(int index)
         return;
 
     mActionManager->removeAt(index, true);
+    invalidateSceneCache();
     emit dataChanged();
 }
 
@@ -125,6 +127,7 @@ void MenuOption::setCondition(const QString& condition)
 {
     if (mCondition != condition) {
         mCondition = condition;
+        invalidateSceneCache();
         emit dataChanged();
     }
 }
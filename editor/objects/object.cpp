@@ -88,6 +88,10 @@ void Object::initEventActionManager(Interaction::InputEvent event)
     connect(actionManager, SIGNAL(objectInserted(int,GameObject*)), this, SLOT(onEventActionInserted(int, GameObject*)));
     connect(actionManager, SIGNAL(objectRemoved(GameObject*, bool)), this, SLOT(onEventActionRemoved(GameObject*, bool)));
     connect(actionManager, SIGNAL(objectMoved(GameObject*, int)), this, SLOT(onEventActionMoved(GameObject*, int)));
+    //the object's signals are blocked while groups sync their objects' actions
+    connect(actionManager, SIGNAL(objectInserted(int,GameObject*)), this, SLOT(invalidateSceneCache()));
+    connect(actionManager, SIGNAL(objectRemoved(GameObject*, bool)), this, SLOT(invalidateSceneCache()));
+    connect(actionManager, SIGNAL(objectMoved(GameObject*, int)), this, SLOT(invalidateSceneCache()));
     mEventToActions.insert(event, actionManager);
 }
 
@@ -359,7 +363,7 @@ int Object::height() const
 
 void Object::update()
 {
-    emit dataChanged();
+    notify(QVariantMap());
 }
 
 bool Object::isRounded() const
@@ -1439,7 +1443,7 @@ void Object::setTemporaryBackgroundImage(ImageFile* image)
         }
 
         mTemporaryBackground.setImage(image);
-        emit dataChanged();
+        notify(QVariantMap());
     }
 }
 
@@ -1452,7 +1456,7 @@ void Object::setTemporaryBackgroundColor(const QColor& color)
 {
     if (mTemporaryBackground.color() != color) {
         mTemporaryBackground.setColor(color);
-        emit dataChanged();
+        notify(QVariantMap());
     }
 }
 
@@ -127,6 +127,7 @@ void ObjectGroup::loadData(const QVariantMap& data, bool internal)
             }
         }
 
+        invalidateChildrenRect();
         setEditingMode(false);
         setX(origX);
         setY(origY);
@@ -150,6 +151,8 @@ void ObjectGroup::init()
     mSpacing = 0;
     mObjectsSynced = false;
     mResizeToContentsEnabled = true;
+    mLoadingOtherObjects = false;
+    mChildrenRectDirty = true;
 }
 
 void ObjectGroup::_append(Object* obj)
@@ -179,6 +182,7 @@ void ObjectGroup::_append(Object* obj)
     }
 
     mObjects.append(obj);
+    invalidateChildrenRect();
 }
 
 void ObjectGroup::append(Object* obj, int x)
@@ -307,6 +311,7 @@ void ObjectGroup::alignObjects()
     if (!mAlignEnabled)
         return;
 
+    ChangeBatch batch(this);
     mAligning = true;
     alignObjectsHorizontally();
     alignObjectsVertically();
@@ -322,6 +327,7 @@ void ObjectGroup::alignObjectsHorizontally()
     int x = this->x(), objX=0, leftspace=0, objWidth=0;
 
     for(int i=0; i < mObjects.size(); i++) {
+        ChangeBatch objectBatch(mObjects[i]);
         objRect = mObjects[i]->sceneRect();
         objWidth = mObjects[i]->width();
 
@@ -345,8 +351,10 @@ void ObjectGroup::alignObjectsHorizontally()
                 objX = x + leftspace;
             else
                 objWidth -= leftspace * -1;
-            mObjects[i]->setX(objX);
-            mObjects[i]->setWidth(objWidth);
+            if (mObjects[i]->x() != objX)
+                mObjects[i]->setX(objX);
+            if (mObjects[i]->width() != objWidth)
+                mObjects[i]->setWidth(objWidth);
             checkStickyObject(mObjects[i]);
         }
         else if (objRect.right() < rect.right()) {
@@ -366,7 +374,8 @@ void ObjectGroup::_alignObjectsVertically()
 {
     int starty = this->y();
     for(int i=0; i < mObjects.size(); i++) {
-        mObjects[i]->setY(starty);
+        if (mObjects[i]->y() != starty)
+            mObjects[i]->setY(starty);
         starty += mObjects[i]->height() + mSpacing;
     }
 }
@@ -379,6 +388,7 @@ void ObjectGroup::adaptSize()
     QRect rect = childrenRect();
 
     if (mResizeToContentsEnabled) {
+        ChangeBatch batch(this);
         Object::setX(rect.left());
         Object::setY(rect.top());
         Object::setWidth(rect.width());
@@ -609,6 +619,8 @@ void ObjectGroup::removeObjectAt(int index, bool del)
 {
     if (index >= 0 && index < mObjects.size()) {
         Object* obj = mObjects.takeAt(index);
+        mObjectRects.remove(obj);
+        invalidateChildrenRect();
         this->notify("objects", variantObjects());
         obj->disconnect(this);
         if (del)
@@ -670,6 +682,15 @@ void ObjectGroup::objectChanged(const QVariantMap& data)
     int index = this->indexOf(sender);
 
     if (index != -1) {
+        bool geometryChanged = data.contains("x") || data.contains("y") || data.contains("width") || data.contains("height");
+        if (geometryChanged)
+            updateChildRect(sender);
+
+        //siblings being synced repeat the change of the object that started it,
+        //clones already get it from that object and the layout is adapted once at the end
+        if (mLoadingOtherObjects)
+            return;
+
         QVariantMap object = data;
         prepareObjectData(object);
         if (!object.isEmpty()) {
@@ -680,7 +701,7 @@ void ObjectGroup::objectChanged(const QVariantMap& data)
         if (mObjectsSynced)
             loadOtherObjects(sender, data);
 
-        if (mEditingMode && (data.contains("x") || data.contains("y") || data.contains("width") || data.contains("height"))) {
+        if (mEditingMode && geometryChanged) {
             bool blocked = blockSignals(true);
             adaptSize();
             blockSignals(blocked);
@@ -764,6 +785,8 @@ void ObjectGroup::loadObject(Object * obj, const QVariantMap & data)
     if (data.contains("visible") && data.value("visible").type() == QVariant::Bool)
         obj->setVisible(data.value("visible").toBool());
     obj->blockNotifications(blocked);
+    //load() doesn't emit dataChanged, so objectChanged won't update the cached bounds
+    updateChildRect(obj);
 }
 
 void ObjectGroup::loadOtherObjects(Object * object, const QVariantMap & data)
@@ -774,11 +797,17 @@ void ObjectGroup::loadOtherObjects(Object * object, const QVariantMap & data)
     QVariantMap _data = data;
     _data.remove("relativeX");
     _data.remove("relativeY");
+    if (_data.isEmpty())
+        return;
 
+    bool loading = mLoadingOtherObjects;
+    mLoadingOtherObjects = true;
     foreach(Object* obj, mObjects) {
-        if (obj != object)
+        if (obj != object) {
             loadObject(obj, _data);
+        }
     }
+    mLoadingOtherObjects = loading;
 }
 
 bool ObjectGroup::isAlignEnabled() const
@@ -800,10 +829,12 @@ QRect ObjectGroup::childrenRect() const
     if (mObjects.isEmpty())
         return QRect();
 
-    int h = 0;
-    int w = width();
+    if (!mChildrenRectDirty)
+        return mChildrenRect;
 
+    mObjectRects.clear();
     QRect rect = mObjects.first()->sceneRect();
+    mObjectRects.insert(mObjects.first(), rect);
     int top = rect.top();
     int left = rect.left();
     int right = rect.right();
@@ -811,6 +842,7 @@ QRect ObjectGroup::childrenRect() const
 
     for(int i=1; i < mObjects.size(); i++) {
         rect = mObjects[i]->sceneRect();
+        mObjectRects.insert(mObjects[i], rect);
         if (rect.top() < top)
             top = rect.top();
         if (rect.left() < left)
@@ -822,10 +854,44 @@ QRect ObjectGroup::childrenRect() const
     }
 
     //Due to Qt's peculiar behaviour we need to add 1 to right/bottom
-    w = (right+1) - left;
-    h = (bottom+1) - top;
+    mChildrenRect = QRect(left, top, (right+1) - left, (bottom+1) - top);
+    mChildrenRectDirty = false;
+    return mChildrenRect;
+}
+
+void ObjectGroup::invalidateChildrenRect()
+{
+    mChildrenRectDirty = true;
+}
+
+//Updates the cached bounds with the new rect of a single child.
+//They only need to be recomputed when a child that was on an edge moves inwards.
+void ObjectGroup::updateChildRect(Object * obj)
+{
+    if (mChildrenRectDirty || !obj)
+        return;
+
+    QRect rect = obj->sceneRect();
+    QHash<Object*, QRect>::iterator it = mObjectRects.find(obj);
+    if (it == mObjectRects.end()) {
+        mChildrenRectDirty = true;
+        return;
+    }
+
+    QRect prevRect = it.value();
+    if (prevRect == rect)
+        return;
+
+    if ((prevRect.left() == mChildrenRect.left() && rect.left() > prevRect.left()) ||
+        (prevRect.top() == mChildrenRect.top() && rect.top() > prevRect.top()) ||
+        (prevRect.right() == mChildrenRect.right() && rect.right() < prevRect.right()) ||
+        (prevRect.bottom() == mChildrenRect.bottom() && rect.bottom() < prevRect.bottom())) {
+        mChildrenRectDirty = true;
+        return;
+    }
 
-    return QRect(left, top, w, h);
+    it.value() = rect;
+    mChildrenRect = mChildrenRect.united(rect);
 }
 
 int ObjectGroup::count() const
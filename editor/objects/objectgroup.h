@@ -17,6 +17,8 @@
 #ifndef OBJECTGROUP_H
 #define OBJECTGROUP_H
 
+#include <QHash>
+
 #include "object.h"
 #include "actionpool.h"
 
@@ -112,6 +114,11 @@ private:
     QList<Action*> mObjectsEventActions;
     QList<ActionPool*> mObjectsActionPools;
     bool mResizeToContentsEnabled;
+    bool mLoadingOtherObjects;
+    //cached bounds of the children and the rects they were computed from
+    mutable QRect mChildrenRect;
+    mutable QHash<Object*, QRect> mObjectRects;
+    mutable bool mChildrenRectDirty;
     void init();
     int indexOf(Object*);
     void alignObjects();
@@ -119,6 +126,8 @@ private:
     void alignObjectsVertically();
     void _alignObjectsVertically();
     void checkStickyObject(Object*);
+    void invalidateChildrenRect();
+    void updateChildRect(Object*);
     QVariantList objectsRelativeRectsData();
     QList<QRect> objectsRelativeRects() const;
     void loadOtherObjects(Object*, const QVariantMap&);
@@ -129,6 +129,11 @@ void TextBox::init(const QString& text, const QVariantMap &data)
     setType(GameObjectMetaType::TextBox);
     mFont.setFamily(Object::defaultFontFamily());
     mFont.setPixelSize(Object::defaultFontSize());
+    mLayoutWidth = -1;
+    mFontHeight = 0;
+    mFontLeading = 0;
+    mStaticText.setTextFormat(Qt::PlainText);
+    mStaticText.setPerformanceHint(QStaticText::AggressiveCaching);
 
     initRect(data);
 }
@@ -207,14 +212,14 @@ void TextBox::setWidth(int w, bool percent)
 {
     Object::setWidth(w, percent);
     mTextRect.setWidth(width());
-    emit dataChanged();
+    notify(QVariantMap());
 }
 
 void TextBox::setHeight(int h, bool percent)
 {
     Object::setHeight(h, percent);
     mTextRect.setHeight(h);
-    emit dataChanged();
+    notify(QVariantMap());
 
 }
 
@@ -274,14 +279,59 @@ void TextBox::paint(QPainter & painter)
         return;
 
     QRect rect(contentRect());
+    QString text = currentText();
+    if (text != mLayoutText || mFont != mLayoutFont || rect.width() != mLayoutWidth || mTextAlignment != mLayoutAlignment)
+        updateTextLayout(text, rect.width());
+
+    QSizeF size = mStaticText.size();
+    qreal y = rect.top();
+    if (mTextAlignment.testFlag(Qt::AlignVCenter))
+        y += (rect.height() - size.height()) / 2;
+    else if (mTextAlignment.testFlag(Qt::AlignBottom))
+        y += rect.height() - size.height();
+
     QPen pen(currentColor());
     painter.save();
     painter.setFont(mFont);
     painter.setPen(pen);
-    painter.drawText(rect, mTextAlignment | Qt::TextWordWrap, currentText());
+    //text that doesn't fit is cut at the edges of the box
+    if (size.width() > rect.width() || size.height() > rect.height())
+        painter.setClipRect(rect, Qt::IntersectClip);
+    painter.drawStaticText(QPointF(rect.left(), y), mStaticText);
     painter.restore();
 }
 
+//Word wrapping and shaping are only done again when something that affects them changes
+void TextBox::updateTextLayout(const QString& text, int width)
+{
+    mLayoutText = text;
+    mLayoutFont = mFont;
+    mLayoutWidth = width;
+    mLayoutAlignment = mTextAlignment;
+
+    QTextOption option(mTextAlignment & Qt::AlignHorizontal_Mask);
+    option.setWrapMode(QTextOption::WordWrap);
+    //QPainter::drawText breaks lines on new lines, QStaticText only on line separators
+    QString layoutText = text;
+    layoutText.replace(QLatin1Char('\n'), QChar::LineSeparator);
+
+    mStaticText.setTextOption(option);
+    mStaticText.setTextWidth(width);
+    mStaticText.setText(layoutText);
+    mStaticText.prepare(QTransform(), mFont);
+}
+
+void TextBox::updateFontMetrics() const
+{
+    if (mFont == mMetricsFont && mFontHeight)
+        return;
+
+    QFontMetrics metrics(mFont);
+    mMetricsFont = mFont;
+    mFontHeight = metrics.height();
+    mFontLeading = metrics.leading();
+}
+
 QVariantMap TextBox::toJsonObject(bool internal) const
 {
     QVariantMap object = Object::toJsonObject(internal);
@@ -290,12 +340,12 @@ QVariantMap TextBox::toJsonObject(bool internal) const
     object.insert("text", mText);
     object.insert("textAlignment", textAlignmentAsString());
     QVariantMap font;
-    QFontMetrics metrics(mFont);
+    updateFontMetrics();
     font.insert("size", QString("%1px").arg(mFont.pixelSize()));
     font.insert("family", mFont.family());
-    if (metrics.leading())
-        font.insert("leading", metrics.leading());
-    font.insert("height", metrics.height());
+    if (mFontLeading)
+        font.insert("leading", mFontLeading);
+    font.insert("height", mFontHeight);
     font.insert("weight", FontLibrary::cssFontWeight(mFont.weight()));
     font.insert("style", FontLibrary::cssFontStyle(mFont.style()));
     object.insert("font", font);
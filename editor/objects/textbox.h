@@ -18,6 +18,7 @@
 #define TEXT_OBJECT_H
 
 #include <QObject>
+#include <QStaticText>
 
 #include "scene.h"
 #include "object.h"
@@ -35,6 +36,15 @@ class TextBox : public Object
     QString mPlaceholderText;
     Qt::Alignment mTextAlignment;
     QFont mFont;
+    //laid out text, kept until the text, font, width or alignment change
+    QStaticText mStaticText;
+    QString mLayoutText;
+    QFont mLayoutFont;
+    int mLayoutWidth;
+    Qt::Alignment mLayoutAlignment;
+    mutable QFont mMetricsFont;
+    mutable int mFontHeight;
+    mutable int mFontLeading;
 
 public:
     explicit TextBox(QObject *parent = 0, const QString& name="");
@@ -96,6 +106,8 @@ private:
     void init(const QString&, const QVariantMap& data=QVariantMap());
     void initRect(const QVariantMap& data=QVariantMap());
     void notifyFont(const QString&, const QVariant&);
+    void updateTextLayout(const QString&, int);
+    void updateFontMetrics() const;
 
 };
 
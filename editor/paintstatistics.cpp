@@ -0,0 +1,157 @@
+#include "paintstatistics.h"
+
+#include <QObject>
+#include <QtAlgorithms>
+
+#include "object.h"
+#include "image.h"
+#include "imagefile.h"
+#include "gameobjectmetatype.h"
+
+#define OVERLAY_WIDTH 260
+#define OVERLAY_HEIGHT 190
+#define OVERLAY_MARGIN 6
+#define HISTOGRAM_HEIGHT 50
+#define FRAME_BUDGET_NSECS 16666666
+#define MAX_KINDS_SHOWN 6
+
+static bool slowerThan(const QPair<qint64, QString>& a, const QPair<qint64, QString>& b)
+{
+    return a.first > b.first;
+}
+
+PaintStatistics::PaintStatistics()
+{
+    mObjects = 0;
+    mFrames = 0;
+}
+
+PaintStatistics::~PaintStatistics()
+{
+}
+
+void PaintStatistics::beginFrame()
+{
+    mKinds.clear();
+    mObjects = 0;
+}
+
+//Called by Scene::paint with the time it took to paint each object, in nanoseconds
+void PaintStatistics::addObject(Object* object, qint64 nsecs)
+{
+    if (! object)
+        return;
+
+    KindStatistics& kind = mKinds[this->kind(object)];
+    kind.count++;
+    kind.time += nsecs;
+    mObjects++;
+}
+
+void PaintStatistics::endFrame(qint64 nsecs)
+{
+    mFrameTimes.append(nsecs);
+    if (mFrameTimes.size() > PAINT_STATISTICS_FRAMES)
+        mFrameTimes.removeFirst();
+    mFrames++;
+}
+
+void PaintStatistics::clear()
+{
+    mFrameTimes.clear();
+    mKinds.clear();
+    mObjects = 0;
+    mFrames = 0;
+}
+
+QString PaintStatistics::kind(Object* object) const
+{
+    const GameObjectMetaType* metaType = GameObjectMetaType::metaType(object->type());
+    QString kind = metaType ? metaType->toString() : QObject::tr("Object");
+
+    if (object->cornerRadius() > 0)
+        kind += QObject::tr(" (rounded)");
+
+    Image* image = qobject_cast<Image*>(object);
+    ImageFile* imageFile = image ? image->image() : object->backgroundImage();
+    if (imageFile && imageFile->isAnimated())
+        kind += QObject::tr(" (animated)");
+
+    return kind;
+}
+
+//The overlay sits in the top left corner of the given area
+QRect PaintStatistics::overlayRect(const QRect& area) const
+{
+    return QRect(area.left() + OVERLAY_MARGIN, area.top() + OVERLAY_MARGIN, OVERLAY_WIDTH, OVERLAY_HEIGHT);
+}
+
+void PaintStatistics::paint(QPainter& painter, const QRect& area) const
+{
+    QRect rect = overlayRect(area);
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.fillRect(rect, QColor(0, 0, 0, 180));
+
+    QFont font = painter.font();
+    font.setPixelSize(11);
+    font.setStyleHint(QFont::Monospace);
+    painter.setFont(font);
+    painter.setPen(Qt::white);
+
+    qint64 last = mFrameTimes.isEmpty() ? 0 : mFrameTimes.last();
+    qint64 total = 0, max = 0;
+    foreach(qint64 time, mFrameTimes) {
+        total += time;
+        max = qMax(max, time);
+    }
+    qint64 average = mFrameTimes.isEmpty() ? 0 : total / mFrameTimes.size();
+
+    QStringList lines;
+    lines << QObject::tr("paint: %1 ms  avg: %2 ms  max: %3 ms").arg(last / 1000000.0, 0, 'f', 2)
+             .arg(average / 1000000.0, 0, 'f', 2).arg(max / 1000000.0, 0, 'f', 2);
+    lines << QObject::tr("frames: %1  objects drawn: %2").arg(mFrames).arg(mObjects);
+
+    //slowest kinds first
+    QList<QPair<qint64, QString> > kinds;
+    QHashIterator<QString, KindStatistics> it(mKinds);
+    while(it.hasNext()) {
+        it.next();
+        kinds.append(qMakePair(it.value().time, it.key()));
+    }
+    qSort(kinds.begin(), kinds.end(), slowerThan);
+    for(int i=0; i < kinds.size() && i < MAX_KINDS_SHOWN; i++) {
+        KindStatistics kind = mKinds.value(kinds[i].second);
+        lines << QString("%1 x%2: %3 ms").arg(kinds[i].second).arg(kind.count).arg(kind.time / 1000000.0, 0, 'f', 2);
+    }
+
+    QRect textRect = rect.adjusted(4, 2, -4, -HISTOGRAM_HEIGHT - 4);
+    painter.drawText(textRect, Qt::AlignLeft | Qt::AlignTop, lines.join("\n"));
+
+    //one bar per frame, red when it took longer than a 60 fps frame; the line marks that budget
+    QRect histogram(rect.left() + 4, rect.bottom() - HISTOGRAM_HEIGHT - 2, rect.width() - 8, HISTOGRAM_HEIGHT);
+    qint64 scale = qMax(max, qint64(FRAME_BUDGET_NSECS * 2));
+    qreal barWidth = qreal(histogram.width()) / PAINT_STATISTICS_FRAMES;
+    for(int i=0; i < mFrameTimes.size(); i++) {
+        int height = qMax(1, int(mFrameTimes[i] * histogram.height() / scale));
+        QColor color = mFrameTimes[i] > FRAME_BUDGET_NSECS ? QColor(230, 60, 60) : QColor(90, 200, 90);
+        painter.fillRect(QRectF(histogram.left() + i * barWidth, histogram.bottom() - height + 1, qMax(barWidth - 1, qreal(1)), height), color);
+    }
+
+    int budgetY = histogram.bottom() - int(FRAME_BUDGET_NSECS * histogram.height() / scale);
+    painter.setPen(QColor(255, 255, 0, 160));
+    painter.drawLine(histogram.left(), budgetY, histogram.right(), budgetY);
+    painter.restore();
+}
+
+//Outlines what was repainted, in a different color every frame, so areas painted more often than needed stand out
+void PaintStatistics::paintRegion(QPainter& painter, const QRegion& region) const
+{
+    painter.save();
+    QColor color = QColor::fromHsv((mFrames * 47) % 360, 255, 255, 200);
+    painter.setPen(QPen(color, 2));
+    painter.setBrush(QColor(color.red(), color.green(), color.blue(), 40));
+    foreach(const QRect& rect, region.rects())
+        painter.drawRect(rect.adjusted(1, 1, -1, -1));
+    painter.restore();
+}
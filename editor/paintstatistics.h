@@ -0,0 +1,46 @@
+#ifndef PAINTSTATISTICS_H
+#define PAINTSTATISTICS_H
+
+#include <QHash>
+#include <QList>
+#include <QPainter>
+#include <QRegion>
+#include <QString>
+
+#define PAINT_STATISTICS_FRAMES 120
+
+class Object;
+
+//Paint times of the drawing surface, per frame and per kind of object, drawn on top of the scene.
+//Objects are grouped by type, with rounded corners and animated images counted apart since they're the slow ones.
+class PaintStatistics
+{
+    struct KindStatistics {
+        int count;
+        qint64 time;
+        KindStatistics() : count(0), time(0) {}
+    };
+
+    QList<qint64> mFrameTimes;
+    QHash<QString, KindStatistics> mKinds;
+    int mObjects;
+    int mFrames;
+
+public:
+    PaintStatistics();
+    virtual ~PaintStatistics();
+
+    void beginFrame();
+    void addObject(Object*, qint64);
+    void endFrame(qint64);
+    void clear();
+
+    QRect overlayRect(const QRect&) const;
+    void paint(QPainter&, const QRect&) const;
+    void paintRegion(QPainter&, const QRegion&) const;
+
+private:
+    QString kind(Object*) const;
+};
+
+#endif // PAINTSTATISTICS_H
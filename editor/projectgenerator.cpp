@@ -0,0 +1,313 @@
+#include "projectgenerator.h"
+
+#include <QObject>
+#include <QImage>
+#include <QPainter>
+#include <QLinearGradient>
+
+#include "belle.h"
+#include "scene.h"
+#include "scene_manager.h"
+#include "resource_manager.h"
+#include "assetmanager.h"
+#include "gameobjectfactory.h"
+#include "exporter.h"
+#include "gotoscene.h"
+#include "utils.h"
+
+#define GENERATED_OBJECT_WIDTH 120
+#define GENERATED_OBJECT_HEIGHT 60
+
+ProjectGenerator::ProjectGenerator(const ProjectGeneratorOptions& options)
+{
+    mOptions = options;
+    mRandom = options.seed;
+}
+
+ProjectGenerator::~ProjectGenerator()
+{
+}
+
+QString ProjectGenerator::errorString() const
+{
+    return mErrorString;
+}
+
+//Same seed, same project
+int ProjectGenerator::random(int max)
+{
+    mRandom = mRandom * 1103515245 + 12345;
+    if (max <= 0)
+        return 0;
+    return (mRandom >> 16) % max;
+}
+
+bool ProjectGenerator::generate(const QDir& dir)
+{
+    mErrorString = "";
+    mImages.clear();
+    mResources.clear();
+    mRandom = mOptions.seed;
+
+    if (! dir.exists() && ! QDir().mkpath(dir.absolutePath())) {
+        mErrorString = QObject::tr("Couldn't create the project directory: %1").arg(dir.absolutePath());
+        return false;
+    }
+
+    Scene::setWidth(WIDTH);
+    Scene::setHeight(HEIGHT);
+    AssetManager* assetManager = AssetManager::instance();
+    assetManager->clear();
+    assetManager->setLoadPath(dir.absolutePath());
+    ResourceManager::instance()->clear(true);
+
+    if (! generateImages(dir))
+        return false;
+    generateResources();
+
+    //scenes are loaded into a scene manager, like in the editor, so actions can find their targets
+    SceneManager sceneManager;
+    for(int i=0; i < mOptions.scenes; i++)
+        sceneManager.addScene(GameObjectFactory::createScene(sceneData(i), &sceneManager));
+
+    QVariantMap gameData;
+    gameData.insert("title", QString("Generated %1x%2").arg(mOptions.scenes).arg(mOptions.objectsPerScene));
+    gameData.insert("width", WIDTH);
+    gameData.insert("height", HEIGHT);
+    gameData.insert("textSpeed", 50);
+    gameData.insert("imageQuality", 85);
+    gameData.insert("imageFormat", QString("jpg"));
+    QVariantMap font;
+    font.insert("size", QString("18px"));
+    font.insert("family", QString("Arial"));
+    gameData.insert("font", font);
+    gameData.insert("version", VERSION);
+    gameData.insert("resources", ResourceManager::instance()->toMap());
+
+    QVariantList scenes;
+    for(int i=0; i < sceneManager.size(); i++)
+        scenes.append(sceneManager.sceneAt(i)->toJsonObject(false));
+    gameData.insert("scenes", scenes);
+    QVariantMap pauseScreen;
+    pauseScreen.insert("scenes", QVariantList());
+    gameData.insert("pauseScreen", pauseScreen);
+
+    sceneManager.removeScenes(true);
+    ResourceManager::instance()->clear(true);
+
+    if (! Exporter::writeGameFile(gameData, dir.absoluteFilePath(GAME_FILENAME))) {
+        mErrorString = QObject::tr("Couldn't write the game file to %1").arg(dir.absolutePath());
+        return false;
+    }
+
+    bool saved = assetManager->save(dir, true);
+    assetManager->clear();
+    if (! saved) {
+        mErrorString = QObject::tr("Couldn't write the assets file to %1").arg(dir.absolutePath());
+        return false;
+    }
+
+    return true;
+}
+
+bool ProjectGenerator::generateImages(const QDir& dir)
+{
+    AssetManager* assetManager = AssetManager::instance();
+
+    for(int i=0; i < mOptions.images; i++) {
+        QString path = dir.absoluteFilePath(QString("image%1.png").arg(i));
+        if (! generateImage(i).save(path)) {
+            mErrorString = QObject::tr("Couldn't write the image %1").arg(path);
+            return false;
+        }
+
+        Asset* asset = assetManager->loadAsset(path, Asset::Image);
+        if (asset)
+            mImages.append(asset->name());
+    }
+
+    return true;
+}
+
+//A gradient with a few shapes on top; every third image has transparent areas
+QImage ProjectGenerator::generateImage(int index)
+{
+    QImage image(mOptions.imageSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    QLinearGradient gradient(0, 0, image.width(), image.height());
+    gradient.setColorAt(0, QColor(random(256), random(256), random(256)));
+    gradient.setColorAt(1, QColor(random(256), random(256), random(256)));
+    if (index % 3 == 0)
+        painter.setBrush(gradient);
+    else
+        painter.fillRect(image.rect(), gradient);
+
+    if (index % 3 == 0)
+        painter.drawEllipse(image.rect());
+
+    for(int i=0; i < 5; i++) {
+        painter.setBrush(QColor(random(256), random(256), random(256), 128 + random(128)));
+        painter.drawEllipse(random(image.width()), random(image.height()), 10 + random(image.width() / 2), 10 + random(image.height() / 2));
+    }
+
+    return image;
+}
+
+void ProjectGenerator::generateResources()
+{
+    ResourceManager* resourceManager = ResourceManager::instance();
+
+    for(int i=0; i < mOptions.resources; i++) {
+        QString name = QString("resource%1").arg(i);
+        QVariantMap data = objectData(name, i);
+        Object* resource = resourceManager->createObject(data);
+        if (! resource)
+            continue;
+        resourceManager->add(resource);
+        mResources.append(resource->name());
+    }
+}
+
+//Text boxes and images, alternating, with some background colors and images
+QVariantMap ProjectGenerator::objectData(const QString& name, int index, int depth)
+{
+    if (index % 5 == 4 && depth < mOptions.groupDepth)
+        return groupData(name, index, depth);
+
+    QVariantMap data;
+    data.insert("name", name);
+    data.insert("x", random(qMax(1, WIDTH - GENERATED_OBJECT_WIDTH)));
+    data.insert("y", random(qMax(1, HEIGHT - GENERATED_OBJECT_HEIGHT)));
+    data.insert("width", GENERATED_OBJECT_WIDTH);
+    data.insert("height", GENERATED_OBJECT_HEIGHT);
+    data.insert("backgroundColor", Utils::colorToList(QColor(random(256), random(256), random(256))));
+    data.insert("backgroundOpacity", random(256));
+
+    if (index % 2 && ! mImages.isEmpty()) {
+        data.insert("type", QString("Image"));
+        data.insert("image", mImages.at(random(mImages.size())));
+    }
+    else {
+        data.insert("type", QString("TextBox"));
+        data.insert("text", QString("%1, generated text number %2").arg(name).arg(index));
+        if (! mImages.isEmpty() && index % 3 == 0)
+            data.insert("backgroundImage", mImages.at(random(mImages.size())));
+    }
+
+    return data;
+}
+
+//Two objects per level, the innermost level holds the leaf objects
+QVariantMap ProjectGenerator::groupData(const QString& name, int index, int depth)
+{
+    QVariantList objects;
+    for(int i=0; i < 2; i++)
+        objects.append(objectData(QString("%1_%2").arg(name).arg(i), index + i, depth + 1));
+
+    QVariantMap data;
+    data.insert("type", QString("ObjectGroup"));
+    data.insert("name", name);
+    data.insert("x", random(qMax(1, WIDTH / 2)));
+    data.insert("y", random(qMax(1, HEIGHT / 2)));
+    data.insert("width", GENERATED_OBJECT_WIDTH * 2);
+    data.insert("height", GENERATED_OBJECT_HEIGHT * 2);
+    data.insert("objects", objects);
+    return data;
+}
+
+//Dialogues, waits, show/hide of the scene objects, labels and forward jumps to them
+QVariantList ProjectGenerator::actionsData(int sceneIndex, const QStringList& objects)
+{
+    int count = mOptions.actionsPerScene;
+    QList<bool> labels;
+    for(int i=0; i < count; i++)
+        labels.append(random(100) < mOptions.labelDensity);
+
+    QVariantList actions;
+    for(int i=0; i < count; i++) {
+        QVariantMap action;
+
+        if (labels[i]) {
+            action.insert("type", QString("Label"));
+            action.insert("name", QString("label%1").arg(i));
+            actions.append(action);
+            continue;
+        }
+
+        //jumps only go forward, so the game always reaches the end of the scene
+        int target = labels.indexOf(true, i + 1);
+        if (target != -1 && random(200) < mOptions.labelDensity) {
+            action.insert("type", QString("GoToLabel"));
+            action.insert("label", QString("label%1").arg(target));
+            actions.append(action);
+            continue;
+        }
+
+        switch(random(4)) {
+        case 0:
+            action.insert("type", QString("Wait"));
+            action.insert("time", 1 + random(3));
+            break;
+        case 1:
+        case 2:
+            if (! objects.isEmpty()) {
+                action.insert("type", QString(random(2) ? "Show" : "Hide"));
+                action.insert("object", objects.at(random(objects.size())));
+                break;
+            }
+            //without objects it's a dialogue
+        default:
+            action.insert("type", QString("Dialogue"));
+            action.insert("text", QString("Scene %1, line %2.").arg(sceneIndex).arg(i));
+            break;
+        }
+
+        actions.append(action);
+    }
+
+    if (sceneIndex < mOptions.scenes - 1) {
+        QVariantMap action;
+        action.insert("type", QString("GoToScene"));
+        action.insert("metaTarget", static_cast<int>(GoToScene::Next));
+        actions.append(action);
+    }
+
+    return actions;
+}
+
+QVariantMap ProjectGenerator::sceneData(int index)
+{
+    QVariantList objects;
+    QStringList names;
+
+    for(int i=0; i < mOptions.objectsPerScene; i++) {
+        QString name = QString("object%1").arg(i);
+        objects.append(objectData(name, i));
+        names.append(name);
+    }
+
+    //clones are spread over the scenes
+    int clones = mResources.size() * mOptions.clonesPerResource;
+    for(int i=index; i < clones; i += qMax(1, mOptions.scenes)) {
+        QVariantMap clone;
+        QString name = QString("clone%1").arg(i);
+        clone.insert("name", name);
+        clone.insert("resource", mResources.at(i / mOptions.clonesPerResource));
+        objects.append(clone);
+        names.append(name);
+    }
+
+    QVariantMap data;
+    data.insert("type", QString("Scene"));
+    data.insert("name", QString("scene%1").arg(index));
+    if (! mImages.isEmpty() && index % 2 == 0)
+        data.insert("backgroundImage", mImages.at(random(mImages.size())));
+    else
+        data.insert("backgroundColor", Utils::colorToList(QColor(random(256), random(256), random(256))));
+    data.insert("objects", objects);
+    data.insert("actions", actionsData(index, names));
+    return data;
+}
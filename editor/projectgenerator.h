@@ -0,0 +1,56 @@
+#ifndef PROJECTGENERATOR_H
+#define PROJECTGENERATOR_H
+
+#include <QDir>
+#include <QSize>
+#include <QStringList>
+#include <QVariantMap>
+
+class Scene;
+
+struct ProjectGeneratorOptions
+{
+    int scenes;
+    int objectsPerScene;
+    int actionsPerScene;
+    int resources;
+    int clonesPerResource;
+    int groupDepth;
+    //percentage of actions that are labels, about half as many jump to one
+    int labelDensity;
+    int images;
+    QSize imageSize;
+    uint seed;
+    ProjectGeneratorOptions() : scenes(10), objectsPerScene(10), actionsPerScene(20), resources(5),
+        clonesPerResource(2), groupDepth(1), labelDensity(10), images(10), imageSize(256, 256), seed(1) {}
+};
+
+//Writes projects of any size that open in the editor, for reproducing scaling problems.
+//Everything goes through the GameObjectFactory and ResourceManager, so the data is what the editor would save.
+class ProjectGenerator
+{
+public:
+    ProjectGenerator(const ProjectGeneratorOptions& options=ProjectGeneratorOptions());
+    virtual ~ProjectGenerator();
+
+    bool generate(const QDir&);
+    QString errorString() const;
+
+private:
+    ProjectGeneratorOptions mOptions;
+    QString mErrorString;
+    QStringList mImages;
+    QStringList mResources;
+    uint mRandom;
+
+    int random(int);
+    bool generateImages(const QDir&);
+    QImage generateImage(int);
+    void generateResources();
+    QVariantMap objectData(const QString&, int, int depth=0);
+    QVariantMap groupData(const QString&, int, int);
+    QVariantList actionsData(int, const QStringList&);
+    QVariantMap sceneData(int);
+};
+
+#endif // PROJECTGENERATOR_H
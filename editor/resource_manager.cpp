@@ -29,6 +29,7 @@
 #include "animatedimage.h"
 #include "gameobjectmanager.h"
 #include "gameobjectfactory.h"
+#include "tracer.h"
 
 static ResourceManager* mInstance = new ResourceManager();
 
@@ -104,6 +105,7 @@ ResourceManager* ResourceManager::instance()
 
 void ResourceManager::load(const QVariantMap& data)
 {
+    TraceSpan span("load resources", "project");
     if (data.contains("resources") && data.value("resources").type() == QVariant::Map) {
         QVariantMap resourcesMap = data.value("resources").toMap();
         QMapIterator<QString, QVariant> it(resourcesMap);
@@ -18,6 +18,7 @@
 
 #include <QDebug>
 #include <QFile>
+#include <QElapsedTimer>
 #include <QtCore/qmath.h>
 
 #include "action.h"
@@ -28,10 +29,14 @@
 #include "drawing_surface_widget.h"
 #include "resource_manager.h"
 #include "gameobjectfactory.h"
+#include "paintstatistics.h"
+#include "undohistory.h"
 
 static QSize mSize;
 static QPoint mPoint;
 static QPixmap* mScenePixmap = 0;
+//bumped to drop the serialized data cached by every scene
+static int mGeneration = 0;
 
 Scene::Scene(QObject *parent, const QString& name):
     GameObject(parent)
@@ -39,7 +44,7 @@ Scene::Scene(QObject *parent, const QString& name):
     init(name);
 }
 
-Scene::Scene(const QVariantMap& data, QObject *parent):
+Scene::Scene(const QVariantMap& data, QObject *parent, bool lazy):
     GameObject(data, parent)
 {
     init("");
@@ -47,6 +52,21 @@ Scene::Scene(const QVariantMap& data, QObject *parent):
     if (data.contains("name") && data.value("name").type() == QVariant::String)
         setName(data.value("name").toString());
 
+    //only keep the raw data around, objects and actions are created when the scene is first needed
+    if (lazy) {
+        mData = data;
+        mLoaded = false;
+        return;
+    }
+
+    loadScene(data);
+}
+
+void Scene::loadScene(const QVariantMap& data)
+{
+    //loading isn't an edit, the objects are already part of the scene
+    bool recordingBlocked = UndoHistory::blockRecording(true);
+
     if (data.contains("backgroundImage") && data.value("backgroundImage").type() == QVariant::String)
         setBackgroundImage(data.value("backgroundImage").toString());
 
@@ -77,9 +97,61 @@ Scene::Scene(const QVariantMap& data, QObject *parent):
         }
     }
 
+    UndoHistory::blockRecording(recordingBlocked);
     emit loaded();
 }
 
+bool Scene::isLoaded() const
+{
+    return mLoaded;
+}
+
+void Scene::load()
+{
+    if (mLoaded)
+        return;
+
+    QVariantMap data = mData;
+    mData.clear();
+    mThumbnail = QIcon();
+    mLoaded = true;
+    loadScene(data);
+}
+
+void Scene::ensureLoaded() const
+{
+    if (! mLoaded)
+        const_cast<Scene*>(this)->load();
+}
+
+void Scene::unload()
+{
+    if (! mLoaded)
+        return;
+
+    mThumbnail = icon();
+    QVariantMap data = toJsonObject(false);
+
+    bool blocked = blockSignals(true);
+    bool recordingBlocked = UndoHistory::blockRecording(true);
+    removeTemporaryBackground();
+    selectObject(0);
+    highlightObject(0);
+    mTemporaryObjectManager.clear();
+    mActionManager->clear(true);
+    mObjectManager.clear(true);
+    clearBackground();
+    mBackgroundColor = QColor();
+    UndoHistory::blockRecording(recordingBlocked);
+    blockSignals(blocked);
+
+    mData = data;
+    mLoaded = false;
+    //unloading doesn't change what's saved
+    mCache = data;
+    mCacheGeneration = mGeneration;
+}
+
 
 Scene::~Scene()
 {
@@ -87,8 +159,12 @@ Scene::~Scene()
     if (mScenePixmap)
         delete mScenePixmap;
     mScenePixmap = 0;
+    bool recordingBlocked = UndoHistory::blockRecording(true);
     mObjectManager.clear();
     mTemporaryObjectManager.clear();
+    UndoHistory::blockRecording(recordingBlocked);
+    //actions in other scenes may refer to this one
+    invalidateAllCaches();
 }
 
 void Scene::init(const QString& name)
@@ -104,6 +180,8 @@ void Scene::init(const QString& name)
     mHighlightedObject = 0;
     mBackgroundImage = 0;
     mTemporaryBackgroundImage = 0;
+    mLoaded = true;
+    mCacheGeneration = -1;
     setType(GameObjectMetaType::Scene);
     //mScenePixmap = new QPixmap(Scene::width(), Scene::height());
     //mScenePixmap->fill(Qt::gray);
@@ -111,6 +189,19 @@ void Scene::init(const QString& name)
     mActionManager->setUniqueNames(false);
     mActionManager->setAllowEmptyNames(true);
     mActionManager->setObjectsParent(this);
+    UndoHistory::instance()->watch(&mObjectManager);
+    UndoHistory::instance()->watch(mActionManager);
+
+    connect(this, SIGNAL(dataChanged(const QVariantMap&)), this, SLOT(invalidateCache(const QVariantMap&)));
+    connect(this, SIGNAL(nameChanged(const QString&)), this, SLOT(onNameChanged()));
+    connect(&mObjectManager, SIGNAL(objectInserted(int,GameObject*)), this, SLOT(invalidateCache()));
+    connect(&mObjectManager, SIGNAL(objectRemoved(GameObject*,bool)), this, SLOT(invalidateCache()));
+    connect(&mObjectManager, SIGNAL(objectTaken(GameObject*)), this, SLOT(invalidateCache()));
+    connect(&mObjectManager, SIGNAL(objectMoved(GameObject*,int)), this, SLOT(invalidateCache()));
+    connect(mActionManager, SIGNAL(objectInserted(int,GameObject*)), this, SLOT(invalidateCache()));
+    connect(mActionManager, SIGNAL(objectRemoved(GameObject*,bool)), this, SLOT(invalidateCache()));
+    connect(mActionManager, SIGNAL(objectTaken(GameObject*)), this, SLOT(invalidateCache()));
+    connect(mActionManager, SIGNAL(objectMoved(GameObject*,int)), this, SLOT(invalidateCache()));
 
     this->setName(name);
 }
@@ -124,6 +215,7 @@ SceneManager* Scene::sceneManager()
 
 QList<Object*> Scene::objects() const
 {
+    ensureLoaded();
     QList<Object*> objects;
     for(int i=0; i < mObjectManager.count(); i++)
         objects << qobject_cast<Object*>(mObjectManager.objectAt(i));
@@ -132,6 +224,7 @@ QList<Object*> Scene::objects() const
 
 QList<Object*> Scene::objects(GameObjectMetaType::Type type) const
 {
+    ensureLoaded();
     QList<Object*> objects;
     for(int i=0; i < mObjectManager.count(); i++)
         if (mObjectManager.objectAt(i)->type() == type)
@@ -150,6 +243,7 @@ QList<Object*> Scene::temporaryObjects() const
 
 Object* Scene::objectAt (qreal x, qreal y)
 {
+    ensureLoaded();
     Object* obj = 0;
 
     QList<Object*> tempObjects = temporaryObjects();
@@ -169,12 +263,14 @@ Object* Scene::objectAt (qreal x, qreal y)
 
 Object* Scene::object(const QString& name)
 {
+    ensureLoaded();
     GameObject* obj = mObjectManager.object(name);
     return qobject_cast<Object*>(obj);
 }
 
 void Scene::addCopyOfObject(Object* object, bool select)
 {
+    ensureLoaded();
     if (! object)
         return;
 
@@ -186,6 +282,7 @@ void Scene::addCopyOfObject(Object* object, bool select)
 
 void Scene::_appendObject(Object* object, bool temporary)
 {
+    ensureLoaded();
     if (! object)
         return;
 
@@ -348,6 +445,7 @@ void Scene::fillWidth()
 
 void Scene::setBackgroundImage(const QString & path)
 {
+    ensureLoaded();
     AssetManager* assetManager = AssetManager::instance();
     ImageFile* image = dynamic_cast<ImageFile*>(assetManager->loadAsset(path, Asset::Image));
 
@@ -369,11 +467,13 @@ void Scene::setBackgroundImage(const QString & path)
     }
 
     mBackgroundImage = image;
+    invalidateCache();
     emit dataChanged();
 }
 
 ImageFile* Scene::backgroundImage()
 {
+    ensureLoaded();
     return mBackgroundImage;
 }
 
@@ -405,14 +505,17 @@ ImageFile* Scene::temporaryBackgroundImage()
 
 void Scene::setBackgroundColor(const QColor& color)
 {
+    ensureLoaded();
     if (mBackgroundColor != color) {
         mBackgroundColor = color;
+        invalidateCache();
         emit dataChanged();
     }
 }
 
 QColor Scene::backgroundColor()
 {
+    ensureLoaded();
     return mBackgroundColor;
 }
 
@@ -431,6 +534,7 @@ QColor Scene::temporaryBackgroundColor()
 
 QString Scene::backgroundPath()
 {
+    ensureLoaded();
     if (mBackgroundImage)
         return mBackgroundImage->path();
     return "";
@@ -438,14 +542,17 @@ QString Scene::backgroundPath()
 
 ImageFile* Scene::background() const
 {
+    ensureLoaded();
     return mBackgroundImage;
 }
 
 void Scene::clearBackground()
 {
+    ensureLoaded();
     if ( mBackgroundImage ) {
         AssetManager::instance()->releaseAsset(mBackgroundImage);
         mBackgroundImage = 0;
+        invalidateCache();
         emit dataChanged();
     }
 }
@@ -558,6 +665,7 @@ void Scene::removeAction(Action* action, bool del)
 
 QList<Action*> Scene::actions() const
 {
+    ensureLoaded();
     QList<GameObject*> objects = mActionManager->objects();
     QList<Action*> actions;
     Action* action = 0;
@@ -578,6 +686,7 @@ void Scene::appendAction(Action * action, bool copy)
 
 void Scene::insertAction(int row, Action* action, bool copy)
 {
+    ensureLoaded();
     if (! action)
         return;
 
@@ -591,12 +700,23 @@ void Scene::insertAction(int row, Action* action, bool copy)
 
 Action* Scene::actionAt(int i) const
 {
+    ensureLoaded();
     GameObject* obj = mActionManager->objectAt(i);
     return qobject_cast<Action*>(obj);
 }
 
 QIcon Scene::icon()
 {
+    if (! mLoaded) {
+        if (mThumbnail.isNull()) {
+            QColor color = Utils::listToColor(mData.value("backgroundColor").toList());
+            QPixmap pixmap(64, 48);
+            pixmap.fill(color.isValid() ? color : Qt::gray);
+            mThumbnail = QIcon(pixmap);
+        }
+        return mThumbnail;
+    }
+
     if (! mScenePixmap)
         mScenePixmap = new QPixmap(Scene::width(), Scene::height());
 
@@ -617,7 +737,53 @@ QPixmap* Scene::pixmap()
     return mScenePixmap;
 }
 
+//The saved form is kept until something in the scene changes, so saving, exporting
+//and running only serialize the scenes edited since the last time.
 QVariantMap Scene::toJsonObject(bool internal)
+{
+    if (! internal && mCacheGeneration == mGeneration)
+        return mCache;
+
+    QVariantMap scene;
+    if (mLoaded)
+        scene = serialize(internal);
+    else {
+        scene = mData;
+        scene.insert("name", name());
+    }
+
+    if (! internal) {
+        mCache = scene;
+        mCacheGeneration = mGeneration;
+    }
+
+    return scene;
+}
+
+void Scene::invalidateCache()
+{
+    mCacheGeneration = -1;
+}
+
+//the background and selection only emit dataChanged() to be repainted
+void Scene::invalidateCache(const QVariantMap& data)
+{
+    if (! data.isEmpty())
+        invalidateCache();
+}
+
+void Scene::invalidateAllCaches()
+{
+    mGeneration++;
+}
+
+//other scenes' actions refer to this one by name
+void Scene::onNameChanged()
+{
+    invalidateAllCaches();
+}
+
+QVariantMap Scene::serialize(bool internal) const
 {
     QVariantMap scene = GameObject::toJsonObject(internal);
 
@@ -645,13 +811,14 @@ QVariantMap Scene::toJsonObject(bool internal)
 
 Scene* Scene::copy()
 {
-    Scene* scene = new Scene(this->toJsonObject(), this->parent());
+    Scene* scene = new Scene(this->toJsonObject(), this->parent(), ! mLoaded);
     scene->setName(name());
     return scene;
 }
 
 void Scene::show()
 {
+    ensureLoaded();
     if (mBackgroundImage && mBackgroundImage->isAnimated()) {
         AnimatedImage* anim = dynamic_cast<AnimatedImage*>(mBackgroundImage);
         anim->movie()->start();
@@ -664,6 +831,9 @@ void Scene::show()
 
 void Scene::hide()
 {
+    if (! mLoaded)
+        return;
+
     removeTemporaryBackground();
     if (mBackgroundImage && mBackgroundImage->isAnimated()) {
         AnimatedImage* anim = dynamic_cast<AnimatedImage*>(mBackgroundImage);
@@ -690,8 +860,9 @@ void Scene::removeTemporaryBackground()
         mTemporaryBackgroundColor = QColor();
 }
 
-void Scene::paint(QPainter & painter)
+void Scene::paint(QPainter & painter, PaintStatistics* statistics)
 {
+    ensureLoaded();
     QColor bgColor = backgroundColor().isValid() ? backgroundColor() : Qt::gray;
 
     if (mTemporaryBackgroundImage && !mTemporaryBackgroundImage->isNull()) {
@@ -714,13 +885,18 @@ void Scene::paint(QPainter & painter)
 
     QList<Object*> objects = this->objects();
     Object * object;
+    QElapsedTimer timer;
 
     for (int i=0; i < objects.size(); i++) {
         object = objects.at(i);
         if (object){
+            if (statistics)
+                timer.start();
             painter.save();
             object->paint(painter);
             painter.restore();
+            if (statistics)
+                statistics->addObject(object, timer.nsecsElapsed());
         }
     }
 
@@ -747,6 +923,7 @@ void Scene::paint(QPainter & painter)
 
 void Scene::resize(int w, int h, bool pos, bool size)
 {
+    ensureLoaded();
     qreal wratio = w / (Scene::width() * 1.0);
     qreal hratio = h / (Scene::height() * 1.0);
 
@@ -766,6 +943,7 @@ void Scene::resize(int w, int h, bool pos, bool size)
 
 int Scene::indexOf(GameObject* obj)
 {
+    ensureLoaded();
     if (qobject_cast<Object*>(obj)) {
         return mObjectManager.indexOf(obj);
     }
@@ -778,9 +956,16 @@ int Scene::indexOf(GameObject* obj)
 
 GameObjectManager* Scene::actionManager() const
 {
+    ensureLoaded();
     return mActionManager;
 }
 
+GameObjectManager* Scene::objectManager()
+{
+    ensureLoaded();
+    return &mObjectManager;
+}
+
 void Scene::onSelectedObjectDestroyed()
 {
     mSelectedObject = 0;
@@ -29,6 +29,7 @@
 #include "gameobjectmanager.h"
 
 class SceneManager;
+class PaintStatistics;
 class Object;
 class Action;
 
@@ -45,11 +46,19 @@ class Scene : public GameObject
     ImageFile *mTemporaryBackgroundImage;
     QColor mBackgroundColor;
     QColor mTemporaryBackgroundColor;
+    QVariantMap mData;
+    QIcon mThumbnail;
+    bool mLoaded;
+    QVariantMap mCache;
+    int mCacheGeneration;
     
     public:
         explicit Scene(QObject *parent = 0, const QString& name="");
-        Scene(const QVariantMap& data, QObject *parent = 0);
+        Scene(const QVariantMap& data, QObject *parent = 0, bool lazy=false);
         ~Scene();
+        bool isLoaded() const;
+        void load();
+        void unload();
         SceneManager* sceneManager();
         QList<Object*> objects() const;
         QList<Object*> objects(GameObjectMetaType::Type) const;
@@ -99,17 +108,19 @@ class Scene : public GameObject
         void appendAction(Action*, bool copy=false);
         Action* actionAt(int) const;
         GameObjectManager* actionManager() const;
+        GameObjectManager* objectManager();
 
         int indexOf(GameObject*);
 
         virtual QVariantMap toJsonObject(bool internal=true);
+        static void invalidateAllCaches();
         QIcon icon();
         QPixmap* pixmap();
 
         void show();
         void hide();
 
-        void paint(QPainter&);
+        void paint(QPainter&, PaintStatistics* statistics=0);
         
     protected:
         void _appendObject(Object*, bool temporary=false);
@@ -120,8 +131,11 @@ class Scene : public GameObject
         void clearRemovedObject(Object*);
         void onSelectedObjectDestroyed();
         void onHighlightedObjectDestroyed();
+        void onNameChanged();
 
     public slots:
+        void invalidateCache();
+        void invalidateCache(const QVariantMap&);
         void moveSelectedObjectUp();
         void moveSelectedObjectDown();
         void fillWidth();
@@ -139,6 +153,9 @@ class Scene : public GameObject
 
 private:
        void init(const QString&);
+       void loadScene(const QVariantMap&);
+       QVariantMap serialize(bool) const;
+       void ensureLoaded() const;
        void removeTemporaryBackground();
 };
 
@@ -19,9 +19,11 @@
 #include <QDebug>
 
 #include "utils.h"
+#include "undohistory.h"
 
 static QSize mSceneSize;
 static Clipboard *mClipboard = 0;
+static int mMaxLoadedScenes = 8;
 
 SceneManager::SceneManager(QObject * parent, const QString& name) :
     QObject(parent)
@@ -30,6 +32,7 @@ SceneManager::SceneManager(QObject * parent, const QString& name) :
     connect(this, SIGNAL(currentSceneChanged()), this, SLOT(onCurrentSceneChanged()));
     setObjectName(name);
     mGameObjectManager.setObjectsParent(this);
+    UndoHistory::instance()->watch(&mGameObjectManager);
 }
 
 SceneManager::~SceneManager()
@@ -52,9 +55,13 @@ void SceneManager::insertScene(int index, Scene * scene)
     connect(scene, SIGNAL(nameChanged(const QString&)), this, SLOT(onSceneNameChanged(const QString&)), Qt::UniqueConnection);
     connect(scene, SIGNAL(dataChanged()), this, SIGNAL(updateDrawingSurfaceWidget()), Qt::UniqueConnection);
     connect(scene, SIGNAL(selectionChanged(Object*)), this, SIGNAL(selectionChanged(Object*)), Qt::UniqueConnection);
+    connect(scene, SIGNAL(loaded()), this, SLOT(onSceneLoaded()), Qt::UniqueConnection);
 
     mCurrentSceneIndex = index;
     mGameObjectManager.insert(index, scene);
+
+    if (scene->isLoaded())
+        touchScene(scene);
 }
 
 Scene* SceneManager::addScene(const QString& name)
@@ -153,6 +160,7 @@ Scene* SceneManager::takeAt(int i)
     Scene* scene = qobject_cast<Scene*>(mGameObjectManager.takeAt(i));
     if (scene)
         scene->disconnect(this);
+    mLoadedScenes.removeAll(scene);
     emit sceneRemoved(i);
     return scene;
 }
@@ -167,10 +175,57 @@ Clipboard* SceneManager::clipboard()
     return mClipboard;
 }
 
+void SceneManager::setMaxLoadedScenes(int max)
+{
+    //the current scene and the one being loaded always have to fit
+    mMaxLoadedScenes = qMax(max, 2);
+}
+
+int SceneManager::maxLoadedScenes()
+{
+    return mMaxLoadedScenes;
+}
+
 void SceneManager::onCurrentSceneChanged()
 {
-    if (currentScene())
-        currentScene()->selectObject(currentScene()->selectedObject());
+    Scene* scene = currentScene();
+    if (scene) {
+        scene->load();
+        touchScene(scene);
+        scene->selectObject(scene->selectedObject());
+    }
+}
+
+void SceneManager::onSceneLoaded()
+{
+    Scene* scene = qobject_cast<Scene*>(sender());
+    if (scene)
+        touchScene(scene);
+}
+
+void SceneManager::touchScene(Scene* scene)
+{
+    mLoadedScenes.removeAll(scene);
+    mLoadedScenes.append(scene);
+    unloadScenes();
+}
+
+//least recently used scenes are serialized back, except for the current one
+void SceneManager::unloadScenes()
+{
+    Scene* current = currentScene();
+    int i = 0;
+
+    while(mLoadedScenes.size() > mMaxLoadedScenes && i < mLoadedScenes.size()) {
+        Scene* scene = mLoadedScenes.at(i);
+        if (scene == current || scene == mLoadedScenes.last()) {
+            i++;
+            continue;
+        }
+
+        mLoadedScenes.removeAt(i);
+        scene->unload();
+    }
 }
 
 int SceneManager::indexOf(Scene* scene)
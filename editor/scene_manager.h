@@ -32,6 +32,7 @@ class SceneManager : public QObject
     Q_OBJECT
 
     GameObjectManager mGameObjectManager;
+    QList<Scene*> mLoadedScenes;
     int mCurrentSceneIndex;
     
     public:
@@ -60,6 +61,8 @@ class SceneManager : public QObject
 
         static void setClipboard(Clipboard*);
         static Clipboard* clipboard();
+        static void setMaxLoadedScenes(int);
+        static int maxLoadedScenes();
         
     signals:
         void resized(const QResizeEvent&);
@@ -72,6 +75,11 @@ class SceneManager : public QObject
     private slots:
         void onCurrentSceneChanged();
         void onSceneNameChanged(const QString&);
+        void onSceneLoaded();
+
+    private:
+        void touchScene(Scene*);
+        void unloadScenes();
 
 };
 
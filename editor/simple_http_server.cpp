@@ -1,8 +1,9 @@
 #include "simple_http_server.h"
 
 #include <QTcpSocket>
+#include <QCryptographicHash>
 #include <QDateTime>
-#include <QRegExp>
+#include <QMutexLocker>
 #include <QStringList>
 #include <QtDebug>
 #include <QFile>
@@ -10,7 +11,7 @@
 #include <QUrl>
 #include <QLocale>
 
-#include "sockettimeout.h"
+#include "httpconnection.h"
 
 SimpleHttpServer::SimpleHttpServer(const QString& address, int port, const QString& dir, QObject *parent) :
     QTcpServer(parent)
@@ -18,6 +19,8 @@ SimpleHttpServer::SimpleHttpServer(const QString& address, int port, const QStri
     mAddress = address;
     mPort = port;
     mDirectory = QDir(dir);
+    mNextThread = 0;
+    mCache = new FileCache(this);
 
     mHttpPorts << 591 << 8008 << 8080 << 8081 << 8090; //common port alternatives for HTTP
 
@@ -37,117 +40,237 @@ SimpleHttpServer::SimpleHttpServer(const QString& address, int port, const QStri
     mMimetypes.insert("png", "image/png");
     mMimetypes.insert("svg", "image/svg+xml");
     mMimetypes.insert("tiff", "image/tiff");
+}
+
+SimpleHttpServer::~SimpleHttpServer()
+{
+    stop();
+}
 
-    connect(this, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+QByteArray HttpResponse::headerData() const
+{
+    QStringList lines;
+    lines << QString("HTTP/1.1 %1 %2").arg(status).arg(reason);
+    lines << headers;
+    lines << (keepAlive ? "Connection: keep-alive" : "Connection: close");
+    return (lines.join("\r\n") + "\r\n\r\n").toUtf8();
 }
 
-void SimpleHttpServer::onNewConnection()
+void SimpleHttpServer::incomingConnection(qintptr socketDescriptor)
 {
-    if (hasPendingConnections()) {
-        QTcpSocket* socket = nextPendingConnection();
-        connect(socket, SIGNAL(readyRead()), this, SLOT(readClient()));
+    if (mThreads.isEmpty()) {
+        QTcpSocket socket;
+        socket.setSocketDescriptor(socketDescriptor);
+        socket.abort();
+        return;
     }
+
+    QThread* thread = mThreads.at(mNextThread);
+    mNextThread = (mNextThread + 1) % mThreads.size();
+
+    //the socket is created in the worker thread, so it belongs to its event loop
+    HttpConnection* connection = new HttpConnection(socketDescriptor, this);
+    connection->moveToThread(thread);
+    connect(thread, SIGNAL(finished()), connection, SLOT(deleteLater()));
+    connect(this, SIGNAL(stopped()), connection, SLOT(close()));
+    QMetaObject::invokeMethod(connection, "start", Qt::QueuedConnection);
 }
 
-void SimpleHttpServer::readClient()
+//An end of 0 means up to the end of the file
+static void parseRange(const QString& range, qint64 size, qint64* start, qint64* end)
 {
-    QTcpSocket* socket = (QTcpSocket*)sender();
-
-    if (socket->canReadLine()) {
-        QMap<QString, QString> headers;
-        QString header_line;
-        QStringList tokens = QString(socket->readLine()).split(QRegExp("[ \r\n][ \r\n]*"));
-        int range_start = 0, range_end = 0;
-        bool isRanged = false;
-        bool keepAlive = true;
-        QString value;
-
-        while(socket->canReadLine()) {
-            header_line = socket->readLine().trimmed();
-            if (header_line.contains(":")) {
-                QStringList parts = header_line.split(":");
-                headers[parts[0].trimmed().toLower()] = parts[1].trimmed();
-            }
+    QStringList parts = range.mid(6).split("-");
+    *start = parts.value(0).toLongLong();
+    *end = parts.value(1).toLongLong();
+    if (! *end || *end >= size)
+        *end = size - 1;
+    if (*start > *end)
+        *start = qMax(qint64(0), *end);
+}
+
+static bool isNotModified(const HttpRequest& request, const CachedFile& file)
+{
+    QString ifNoneMatch = request.header("if-none-match");
+    if (! ifNoneMatch.isEmpty()) {
+        foreach(const QString& tag, ifNoneMatch.split(",")) {
+            QString etag = tag.trimmed();
+            if (etag.startsWith("W/"))
+                etag = etag.mid(2);
+            if (etag == file.etag || etag == "*")
+                return true;
         }
+        return false;
+    }
 
-        if (headers.contains("range")) {
-            value = headers.value("range", "");
-            if (value.contains("-")) {
-                QString range = value.replace("bytes=", "");
-                range_start = range.split("-")[0].toInt();
-                range_end = range.split("-")[1].toInt();
-                isRanged = true;
+    return request.header("if-modified-since") == file.lastModified;
+}
+
+HttpResponse SimpleHttpServer::respond(const HttpRequest& request)
+{
+    HttpResponse response;
+    response.keepAlive = request.keepAlive();
+    bool head = request.method == "HEAD";
+
+    if (request.method != "GET" && ! head) {
+        response.status = 501;
+        response.reason = "Not Implemented";
+        response.headers << "Content-Length: 0";
+    }
+    else if (request.target.split('?').first() == EVENTS_PATH) {
+        response.eventStream = true;
+        response.keepAlive = true;
+        response.headers << "Content-Type: text/event-stream";
+        response.headers << "Cache-Control: no-cache";
+        //reconnect quickly when the editor restarts the server
+        response.body = "retry: 1000\n\n";
+    }
+    else {
+        QFileInfo fileInfo = this->fileInfo(request.target);
+        QString range = request.header("range");
+        bool isRanged = range.startsWith("bytes=") && range.contains("-");
+        //range requests always get the plain file
+        bool gzip = ! isRanged && acceptsGzip(request.header("accept-encoding"));
+        QString key = fileInfo.absoluteFilePath() + (gzip ? "\ngzip" : "");
+
+        //warm requests are answered without touching the disk
+        CachedFile file;
+        bool cached = mCache->lookup(key, &file);
+        if (! cached) {
+            //directories are answered with their index page
+            if (fileInfo.isDir()) {
+                QDir dir(fileInfo.absoluteFilePath());
+                if (dir.exists("index.html"))
+                    fileInfo = QFileInfo(dir.absoluteFilePath("index.html"));
+                else if (dir.exists("index.htm"))
+                    fileInfo = QFileInfo(dir.absoluteFilePath("index.htm"));
             }
-        }
 
-        if (headers.contains("connection")) {
-            value = headers.value("connection");
-            if (value.toLower() == "close")
-                keepAlive = false;
+            if (fileInfo.isFile())
+                cached = cacheFile(fileInfo, gzip, key, &file);
         }
 
-        if (tokens.size() > 1 && tokens[0] == "GET") {
-            QStringList header;
-            QString file = tokens[1];
-            QFileInfo fileInfo = this->fileInfo(file);
-            QByteArray data;
-            QString mimetype = "text/html";
-            QString rangeinfo("");
-
-            if (!fileInfo.exists()) {
-                header << "HTTP/1.1 404 Not Found";
-                header << QString("Content-Type: %1").arg(mimetype);
-                header << "Connection: close";
-                keepAlive = false;
+        if (cached) {
+            if (isNotModified(request, file)) {
+                response.status = 304;
+                response.reason = "Not Modified";
             }
             else {
-                if (fileInfo.isFile()) {
-                    mimetype = guessMimeType(fileInfo);
-                    data = readFile(fileInfo.absoluteFilePath());
-                    if (isRanged) {
-                        int size = data.size();
-                        if (!range_end)
-                            range_end = size - 1;
-
-                        data = data.mid(range_start, (range_end - range_start)+1);
-                        rangeinfo = QString("bytes %1-%2/%3").arg(range_start).arg(range_end).arg(size);
-                    }
-                }
-                else if (fileInfo.isDir()) {
-                    data = readDir(fileInfo.absoluteFilePath());
-                }
-
+                qint64 size = file.data.size();
+                qint64 rangeStart = 0, rangeEnd = size - 1;
                 if (isRanged) {
-                    header << "HTTP/1.1 206 Partial Content";
-                    header << QString("Accept-Ranges: bytes");
-                    header << QString("Content-Range: %1").arg(rangeinfo);
-                }
-                else {
-                    header << "HTTP/1.1 200 Ok";
+                    parseRange(range, size, &rangeStart, &rangeEnd);
+                    response.status = 206;
+                    response.reason = "Partial Content";
+                    response.headers << QString("Accept-Ranges: bytes");
+                    response.headers << QString("Content-Range: bytes %1-%2/%3").arg(rangeStart).arg(rangeEnd).arg(size);
                 }
 
-                header << QString("Content-Type: %1").arg(mimetype);
-                header << QString("Content-Length: %1").arg(data.size());
-                header << QString("Last-Modified: %1").arg(httpDate(fileInfo.lastModified()));
-                if (keepAlive)
-                    header << "Connection: keep-alive";
+                qint64 length = qMax(qint64(0), rangeEnd - rangeStart + 1);
+                if (! head)
+                    response.body = file.data.mid(rangeStart, length);
+                response.headers << QString("Content-Type: %1").arg(file.mimetype);
+                if (file.compressed)
+                    response.headers << "Content-Encoding: gzip";
+                response.headers << QString("Content-Length: %1").arg(length);
             }
 
-            header << "Server: Belle/0.7";
-            header << QString("Date: %1").arg(httpDate(QDateTime::currentDateTime()));
-            header << "\r\n";
-
-            socket->write(header.join("\r\n").toUtf8());
-            if (data.size())
-                socket->write(data);
+            if (file.mimetype.startsWith("text/") || file.mimetype == "application/javascript")
+                response.headers << "Vary: Accept-Encoding";
+            response.headers << QString("Last-Modified: %1").arg(file.lastModified);
+            response.headers << QString("ETag: %1").arg(file.etag);
+        }
+        else if (fileInfo.isFile()) {
+            //too big for the cache, it's streamed from disk
+            QString mimetype = guessMimeType(fileInfo);
+            QFileInfo gzipInfo = gzip ? compressedFileInfo(fileInfo) : QFileInfo();
+            bool compressed = gzipInfo.exists();
+            QFileInfo sentInfo = compressed ? gzipInfo : fileInfo;
+            qint64 size = sentInfo.size();
+            qint64 rangeStart = 0, rangeEnd = size - 1;
+            if (isRanged) {
+                parseRange(range, size, &rangeStart, &rangeEnd);
+                response.status = 206;
+                response.reason = "Partial Content";
+                response.headers << QString("Accept-Ranges: bytes");
+                response.headers << QString("Content-Range: bytes %1-%2/%3").arg(rangeStart).arg(rangeEnd).arg(size);
+            }
 
-            quint32 timeout = 0;
-            if (keepAlive)
-                timeout = KEEP_ALIVE_TIMEOUT * 1000;
+            qint64 length = qMax(qint64(0), rangeEnd - rangeStart + 1);
+            if (! head) {
+                response.filePath = sentInfo.absoluteFilePath();
+                response.fileOffset = rangeStart;
+                response.fileLength = length;
+            }
 
-            new SocketTimeout(socket, timeout, this);
+            response.headers << QString("Content-Type: %1").arg(mimetype);
+            if (compressed)
+                response.headers << "Content-Encoding: gzip";
+            response.headers << QString("Content-Length: %1").arg(length);
+            response.headers << QString("Last-Modified: %1").arg(httpDate(fileInfo.lastModified()));
+        }
+        else if (fileInfo.isDir()) {
+            QByteArray data = readDir(fileInfo.absoluteFilePath());
+            if (! head)
+                response.body = data;
+            response.headers << "Content-Type: text/html";
+            response.headers << QString("Content-Length: %1").arg(data.size());
+            response.headers << QString("Last-Modified: %1").arg(httpDate(fileInfo.lastModified()));
+        }
+        else {
+            response.status = 404;
+            response.reason = "Not Found";
+            response.headers << "Content-Type: text/html";
+            response.headers << "Content-Length: 0";
         }
     }
+
+    response.headers << "Server: Belle/0.7";
+    response.headers << QString("Date: %1").arg(httpDate(QDateTime::currentDateTime()));
+    if (response.keepAlive && ! response.eventStream)
+        response.headers << QString("Keep-Alive: timeout=%1").arg(KEEP_ALIVE_TIMEOUT);
+
+    return response;
+}
+
+//Sends an event to all the connected event streams
+void SimpleHttpServer::publish(const QString& event, const QByteArray& data)
+{
+    emit eventPublished(event, data);
+}
+
+int SimpleHttpServer::subscriberCount() const
+{
+    return mSubscribers.load();
+}
+
+void SimpleHttpServer::addSubscribers(int count)
+{
+    mSubscribers.fetchAndAddOrdered(count);
+}
+
+//Reads a small file (or its gzipped copy) along with its headers into the cache
+bool SimpleHttpServer::cacheFile(const QFileInfo& fileInfo, bool gzip, const QString& key, CachedFile* file)
+{
+    QFileInfo gzipInfo = gzip ? compressedFileInfo(fileInfo) : QFileInfo();
+    QFileInfo sentInfo = gzipInfo.exists() ? gzipInfo : fileInfo;
+    if (sentInfo.size() > FILE_CACHE_MAX_FILE_SIZE)
+        return false;
+
+    QFile source(sentInfo.absoluteFilePath());
+    if (! source.open(QFile::ReadOnly))
+        return false;
+
+    file->data = source.readAll();
+    file->compressed = gzipInfo.exists();
+    file->mimetype = guessMimeType(fileInfo);
+    file->lastModified = httpDate(fileInfo.lastModified());
+    file->etag = QString("\"%1\"").arg(QString(QCryptographicHash::hash(file->data, QCryptographicHash::Md5).toHex()));
+    file->files << fileInfo.absoluteFilePath();
+    if (file->compressed)
+        file->files << gzipInfo.absoluteFilePath();
+
+    mCache->insert(key, *file);
+    return true;
 }
 
 QByteArray SimpleHttpServer::readFile(const QString& filePath)
@@ -179,18 +302,12 @@ QByteArray SimpleHttpServer::readDir(const QString& dirPath)
     else if (dir.exists("index.htm"))
         data = readFile(dir.absoluteFilePath("index.htm"));
     else
-        data = QString("No index.html or index.htm found at \"%1\".").arg(mDirectory.absolutePath()).toUtf8();
+        data = QString("No index.html or index.htm found at \"%1\".").arg(serverDirectory()).toUtf8();
 
     return data;
 }
 
-void SimpleHttpServer::discardClient()
-{
-    QTcpSocket* socket = (QTcpSocket*)sender();
-    socket->deleteLater();
-}
-
-QString SimpleHttpServer::guessMimeType(const QFileInfo& fileInfo)
+QString SimpleHttpServer::guessMimeType(const QFileInfo& fileInfo) const
 {
     QString ext = fileInfo.suffix();
 
@@ -223,25 +340,52 @@ bool SimpleHttpServer::start()
     mPort = serverPort();
     qDebug() << "Serving HTTP on" << address.toString() << "port" << mPort;
 
+    if (isListening() && mThreads.isEmpty()) {
+        int threadCount = qBound(2, QThread::idealThreadCount(), 4);
+        for(int i=0; i < threadCount; i++) {
+            QThread* thread = new QThread(this);
+            thread->start();
+            mThreads.append(thread);
+        }
+        mNextThread = 0;
+    }
+
     return isListening();
 }
 
 void SimpleHttpServer::stop()
 {
     close();
+    emit stopped();
+
+    foreach(QThread* thread, mThreads) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+    mThreads.clear();
 }
 
+//Exports replace the files right before the preview is opened, so the cache starts over
 void SimpleHttpServer::setServerDirectory(const QString & path)
 {
+    QMutexLocker locker(&mMutex);
     mDirectory.setPath(path);
+    mCache->clear();
+}
+
+FileCache* SimpleHttpServer::cache() const
+{
+    return mCache;
 }
 
-QString SimpleHttpServer::serverDirectory()
+QString SimpleHttpServer::serverDirectory() const
 {
+    QMutexLocker locker(&mMutex);
     return mDirectory.absolutePath();
 }
 
-QFileInfo SimpleHttpServer::fileInfo(const QString& filepath)
+QFileInfo SimpleHttpServer::fileInfo(const QString& filepath) const
 {
     QString path = filepath;
     path = path.split('?')[0];
@@ -251,10 +395,36 @@ QFileInfo SimpleHttpServer::fileInfo(const QString& filepath)
     if (path.startsWith("/"))
         path.remove(0, 1);
 
-    QFileInfo info(mDirectory.absoluteFilePath(path));
+    QFileInfo info(QDir(serverDirectory()).absoluteFilePath(path));
     return info;
 }
 
+bool SimpleHttpServer::acceptsGzip(const QString& acceptEncoding) const
+{
+    foreach(const QString& encoding, acceptEncoding.split(",", QString::SkipEmptyParts)) {
+        QStringList parts = encoding.split(";");
+        QString name = parts[0].trimmed().toLower();
+        if (name != "gzip" && name != "*")
+            continue;
+
+        if (parts.size() > 1 && parts[1].trimmed().startsWith("q=") && parts[1].trimmed().mid(2).toFloat() <= 0)
+            return false;
+        return true;
+    }
+
+    return false;
+}
+
+//Returns the gzipped sibling of the file if it isn't older than the file
+QFileInfo SimpleHttpServer::compressedFileInfo(const QFileInfo& info) const
+{
+    QFileInfo gzipInfo(info.absoluteFilePath() + ".gz");
+    if (! gzipInfo.isFile() || gzipInfo.lastModified() < info.lastModified())
+        return QFileInfo();
+
+    return gzipInfo;
+}
+
 void SimpleHttpServer::setServerPort(qint64 port)
 {
     mPort = port;
@@ -265,7 +435,7 @@ QString SimpleHttpServer::serverUrl()
     return QString("http://%1:%2").arg(serverAddress().toString()).arg(serverPort());
 }
 
-QString SimpleHttpServer::httpDate(const QDateTime & date)
+QString SimpleHttpServer::httpDate(const QDateTime & date) const
 {
     QLocale en(QLocale::English);
     QDateTime utcDate = date.toUTC();
@@ -2,12 +2,37 @@
 #define SIMPLE_HTTP_SERVER_H
 
 #include <QTcpServer>
+#include <QAtomicInt>
 #include <QDir>
-#include <QTimer>
-#include <QTcpSocket>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+
+#include "httprequestparser.h"
+#include "filecache.h"
 
 const quint32 KEEP_ALIVE_TIMEOUT = 5;
+//server-sent events for previews that update themselves
+#define EVENTS_PATH "/__belle/events"
+
+struct HttpResponse
+{
+    int status;
+    QString reason;
+    QStringList headers;
+    QByteArray body;
+    QString filePath; //streamed when set, instead of body
+    qint64 fileOffset;
+    qint64 fileLength;
+    bool keepAlive;
+    bool eventStream; //the connection stays open to receive events
 
+    HttpResponse() : status(200), reason("OK"), fileOffset(0), fileLength(0), keepAlive(true), eventStream(false) {}
+    QByteArray headerData() const;
+};
+
+//Connections are spread over a few worker threads, each with its own event loop,
+//so file I/O never blocks the editor. respond() is called from those threads.
 class SimpleHttpServer : public QTcpServer
 {
     Q_OBJECT
@@ -17,29 +42,42 @@ class SimpleHttpServer : public QTcpServer
     qint64 mPort;
     QDir mDirectory;
     QList<int> mHttpPorts;
+    QList<QThread*> mThreads;
+    int mNextThread;
+    FileCache* mCache;
+    QAtomicInt mSubscribers;
+    mutable QMutex mMutex;
 
 public:
     explicit SimpleHttpServer(const QString& address="127.0.0.1", int port=0, const QString& dir=".", QObject *parent = 0);
+    virtual ~SimpleHttpServer();
     QByteArray readFile(const QString&);
     QByteArray readDir(const QString&);
     bool start();
     void stop();
     void setServerPort(qint64);
     void setServerDirectory(const QString&);
-    QString serverDirectory();
+    QString serverDirectory() const;
     QString serverUrl();
+    FileCache* cache() const;
+
+    HttpResponse respond(const HttpRequest&);
+    void publish(const QString& event, const QByteArray& data);
+    int subscriberCount() const;
+    void addSubscribers(int);
 
 protected:
-    QString guessMimeType(const QFileInfo&);
-    QString httpDate(const QDateTime&);
-    QFileInfo fileInfo(const QString&);
+    virtual void incomingConnection(qintptr);
+    QString guessMimeType(const QFileInfo&) const;
+    QString httpDate(const QDateTime&) const;
+    QFileInfo fileInfo(const QString&) const;
+    bool acceptsGzip(const QString&) const;
+    QFileInfo compressedFileInfo(const QFileInfo&) const;
+    bool cacheFile(const QFileInfo&, bool gzip, const QString& key, CachedFile*);
 
 signals:
-
-protected slots:
-    void onNewConnection();
-    void readClient();
-    void discardClient();
+    void stopped();
+    void eventPublished(const QString&, const QByteArray&);
 
 };
 
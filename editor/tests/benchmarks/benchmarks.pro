@@ -0,0 +1,39 @@
+# QtTest benchmarks for the editor core, built from the editor sources.
+# Build it in its own directory, e.g.: qmake ../editor/tests/benchmarks/benchmarks.pro && make
+# "make benchmark" runs them and writes the results to benchmarks.xml for comparing releases.
+EDITOR_DIR = $$PWD/../..
+include($$EDITOR_DIR/belle.pro)
+
+TARGET = belle-benchmarks
+QT += testlib
+CONFIG += console testcase
+CONFIG -= app_bundle debug
+CONFIG += release
+
+#belle.pro lists its files relative to the editor directory
+EDITOR_HEADERS = $$HEADERS
+EDITOR_SOURCES = $$SOURCES
+EDITOR_SOURCES -= main.cpp
+EDITOR_FORMS = $$FORMS
+EDITOR_RESOURCES = $$RESOURCES
+EDITOR_PATHS = $$INCLUDEPATH
+
+HEADERS =
+SOURCES =
+FORMS =
+RESOURCES =
+INCLUDEPATH = $$EDITOR_DIR
+DEPENDPATH = $$EDITOR_DIR
+
+for(f, EDITOR_HEADERS): HEADERS += $$EDITOR_DIR/$$f
+for(f, EDITOR_SOURCES): SOURCES += $$EDITOR_DIR/$$f
+for(f, EDITOR_FORMS): FORMS += $$EDITOR_DIR/$$f
+for(f, EDITOR_RESOURCES): RESOURCES += $$EDITOR_DIR/$$f
+for(f, EDITOR_PATHS): INCLUDEPATH += $$EDITOR_DIR/$$f
+
+HEADERS += editorbenchmark.h
+SOURCES += editorbenchmark.cpp
+
+benchmark.commands = ./$$TARGET -o benchmarks.xml,xml -o -,txt
+benchmark.depends = $$TARGET
+QMAKE_EXTRA_TARGETS += benchmark
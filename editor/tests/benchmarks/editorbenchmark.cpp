@@ -0,0 +1,291 @@
+#include "editorbenchmark.h"
+
+#include <QtTest>
+#include <QImage>
+#include <QPainter>
+
+#include "scene.h"
+#include "scene_manager.h"
+#include "resource_manager.h"
+#include "assetmanager.h"
+#include "gameobjectfactory.h"
+#include "fontlibrary.h"
+#include "exporter.h"
+#include "imagefile.h"
+#include "utils.h"
+
+#define SCENE_WIDTH 640
+#define SCENE_HEIGHT 480
+
+static void addSizes(const char* column, const QList<int>& sizes)
+{
+    QTest::addColumn<int>(column);
+    foreach(int size, sizes)
+        QTest::newRow(QByteArray::number(size).constData()) << size;
+}
+
+void EditorBenchmark::initTestCase()
+{
+    QVERIFY(mTempDir.isValid());
+    Scene::setWidth(SCENE_WIDTH);
+    Scene::setHeight(SCENE_HEIGHT);
+    GameObjectFactory::init();
+    FontLibrary::init();
+}
+
+void EditorBenchmark::cleanupTestCase()
+{
+    AssetManager::destroy();
+    ResourceManager::destroy();
+}
+
+//Text boxes spread over a grid, every fourth one with its own background color
+QVariantMap EditorBenchmark::objectData(int index) const
+{
+    QVariantMap data;
+    data.insert("type", QString("TextBox"));
+    data.insert("name", QString("object%1").arg(index));
+    data.insert("x", (index * 37) % (SCENE_WIDTH - 50));
+    data.insert("y", (index * 23) % (SCENE_HEIGHT - 30));
+    data.insert("width", 50);
+    data.insert("height", 30);
+    data.insert("text", QString("Text %1").arg(index));
+    if (index % 4 == 0)
+        data.insert("backgroundColor", Utils::colorToList(QColor(index % 255, 100, 100, 200)));
+    return data;
+}
+
+QVariantMap EditorBenchmark::sceneData(const QString& name, int objects) const
+{
+    QVariantList objectsData;
+    QVariantList actionsData;
+    for(int i=0; i < objects; i++) {
+        objectsData.append(objectData(i));
+
+        QVariantMap action;
+        action.insert("type", QString("Wait"));
+        action.insert("time", 1);
+        actionsData.append(action);
+    }
+
+    QVariantMap data;
+    data.insert("type", QString("Scene"));
+    data.insert("name", name);
+    data.insert("backgroundColor", Utils::colorToList(Qt::gray));
+    data.insert("objects", objectsData);
+    data.insert("actions", actionsData);
+    return data;
+}
+
+//Writes a project with the given number of images and its assets file, returns its path
+QString EditorBenchmark::createAssetsProject(int images)
+{
+    QString path = mTempDir.path() + QString("/assets%1").arg(images);
+    QDir dir(path);
+    if (dir.exists(ASSETS_FILE))
+        return path;
+    QDir().mkpath(path);
+
+    AssetManager* assetManager = AssetManager::instance();
+    assetManager->clear();
+    for(int i=0; i < images; i++) {
+        QImage image(64 + i % 64, 64, QImage::Format_ARGB32);
+        image.fill(QColor(i % 255, 50, 150, i % 2 ? 255 : 128));
+        QString imagePath = QDir(mTempDir.path()).absoluteFilePath(QString("image%1.png").arg(i));
+        image.save(imagePath);
+        assetManager->loadAsset(imagePath, Asset::Image);
+    }
+
+    assetManager->save(dir, true);
+    assetManager->clear();
+    return path;
+}
+
+//The same data Belle::createGameFile builds, written to disk and read back
+void EditorBenchmark::gameFileRoundTrip_data()
+{
+    addSizes("scenes", QList<int>() << 10 << 100 << 500);
+}
+
+void EditorBenchmark::gameFileRoundTrip()
+{
+    QFETCH(int, scenes);
+    SceneManager sceneManager;
+    for(int i=0; i < scenes; i++)
+        sceneManager.addScene(new Scene(sceneData(QString("scene%1").arg(i), 20), &sceneManager));
+    QString path = QDir(mTempDir.path()).absoluteFilePath(GAME_FILENAME);
+    QVariantMap gameData;
+
+    QBENCHMARK {
+        //as if every scene was edited since the last save
+        Scene::invalidateAllCaches();
+        QVariantMap data;
+        data.insert("resources", ResourceManager::instance()->toMap());
+        QVariantList scenesData;
+        for(int i=0; i < sceneManager.size(); i++)
+            scenesData.append(sceneManager.sceneAt(i)->toJsonObject(false));
+        data.insert("scenes", scenesData);
+
+        Exporter::writeGameFile(data, path);
+        gameData = Exporter::readGameFile(path);
+    }
+
+    QCOMPARE(gameData.value("scenes").toList().size(), scenes);
+}
+
+void EditorBenchmark::sceneConstruction_data()
+{
+    addSizes("objects", QList<int>() << 10 << 100 << 1000);
+}
+
+void EditorBenchmark::sceneConstruction()
+{
+    QFETCH(int, objects);
+    QVariantMap data = sceneData("scene", objects);
+
+    QBENCHMARK {
+        Scene scene(data);
+    }
+}
+
+void EditorBenchmark::scenePaint_data()
+{
+    addSizes("objects", QList<int>() << 10 << 100 << 1000);
+}
+
+void EditorBenchmark::scenePaint()
+{
+    QFETCH(int, objects);
+    Scene scene(sceneData("scene", objects));
+    QImage image(SCENE_WIDTH, SCENE_HEIGHT, QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        QPainter painter(&image);
+        scene.paint(painter);
+    }
+}
+
+void EditorBenchmark::sceneObjectAt_data()
+{
+    addSizes("objects", QList<int>() << 10 << 100 << 1000);
+}
+
+//A 20x20 grid of hit tests, like the mouse moving over the scene
+void EditorBenchmark::sceneObjectAt()
+{
+    QFETCH(int, objects);
+    Scene scene(sceneData("scene", objects));
+    int found = 0;
+
+    QBENCHMARK {
+        found = 0;
+        for(int x=0; x < SCENE_WIDTH; x += SCENE_WIDTH / 20)
+            for(int y=0; y < SCENE_HEIGHT; y += SCENE_HEIGHT / 20)
+                if (scene.objectAt(x, y))
+                    found++;
+    }
+
+    QVERIFY(found > 0);
+}
+
+void EditorBenchmark::syncClones_data()
+{
+    addSizes("clones", QList<int>() << 10 << 100 << 1000);
+}
+
+//Changing a resource updates every object created from it
+void EditorBenchmark::syncClones()
+{
+    QFETCH(int, clones);
+    ResourceManager* resourceManager = ResourceManager::instance();
+    QVariantMap data = objectData(0);
+    data.insert("name", QString("resource%1").arg(clones));
+    Object* resource = resourceManager->createObject(data);
+    QVERIFY(resource);
+    resourceManager->add(resource);
+
+    QList<Object*> objects;
+    QVariantMap cloneData;
+    cloneData.insert("resource", resource->name());
+    for(int i=0; i < clones; i++)
+        objects.append(resourceManager->createObject(cloneData));
+
+    int x = 0;
+    QBENCHMARK {
+        x = (x + 1) % SCENE_WIDTH;
+        resource->setX(x);
+    }
+
+    QCOMPARE(objects.last()->x(), x);
+    qDeleteAll(objects);
+    resourceManager->remove(resource, true);
+}
+
+void EditorBenchmark::assetManagerLoad_data()
+{
+    addSizes("images", QList<int>() << 10 << 100 << 500);
+}
+
+void EditorBenchmark::assetManagerLoad()
+{
+    QFETCH(int, images);
+    QString path = createAssetsProject(images);
+    AssetManager* assetManager = AssetManager::instance();
+
+    QBENCHMARK {
+        assetManager->clear();
+        assetManager->setLoadPath(path);
+        assetManager->load(QDir(path));
+    }
+
+    QCOMPARE(assetManager->assets(Asset::Image).size(), images);
+    assetManager->clear();
+}
+
+void EditorBenchmark::assetManagerSave_data()
+{
+    addSizes("images", QList<int>() << 10 << 100 << 500);
+}
+
+//Exporting, with duplicate detection, image transforms and atlases
+void EditorBenchmark::assetManagerSave()
+{
+    QFETCH(int, images);
+    QString path = createAssetsProject(images);
+    AssetManager* assetManager = AssetManager::instance();
+    assetManager->setLoadPath(path);
+    assetManager->load(QDir(path));
+
+    QDir exportDir(mTempDir.path() + QString("/export%1").arg(images));
+    QDir().mkpath(exportDir.absolutePath());
+    bool saved = false;
+
+    QBENCHMARK {
+        saved = assetManager->save(exportDir);
+    }
+
+    QVERIFY(saved);
+    assetManager->clear();
+}
+
+void EditorBenchmark::imageTransparency_data()
+{
+    addSizes("size", QList<int>() << 256 << 1024 << 2048);
+}
+
+//Opaque images are the worst case, every pixel is checked
+void EditorBenchmark::imageTransparency()
+{
+    QFETCH(int, size);
+    QImage image(size, size, QImage::Format_ARGB32);
+    image.fill(Qt::darkCyan);
+    bool transparent = true;
+
+    QBENCHMARK {
+        transparent = ImageFile::isTransparent(image);
+    }
+
+    QVERIFY(! transparent);
+}
+
+QTEST_MAIN(EditorBenchmark)
@@ -0,0 +1,43 @@
+#ifndef EDITORBENCHMARK_H
+#define EDITORBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryDir>
+#include <QVariantMap>
+
+//Benchmarks for the code paths that make big projects slow to open, edit and export.
+//Sizes are columns of the data tables, so results can be compared between releases.
+class EditorBenchmark : public QObject
+{
+    Q_OBJECT
+
+    QTemporaryDir mTempDir;
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void gameFileRoundTrip_data();
+    void gameFileRoundTrip();
+    void sceneConstruction_data();
+    void sceneConstruction();
+    void scenePaint_data();
+    void scenePaint();
+    void sceneObjectAt_data();
+    void sceneObjectAt();
+    void syncClones_data();
+    void syncClones();
+    void assetManagerLoad_data();
+    void assetManagerLoad();
+    void assetManagerSave_data();
+    void assetManagerSave();
+    void imageTransparency_data();
+    void imageTransparency();
+
+private:
+    QVariantMap sceneData(const QString&, int) const;
+    QVariantMap objectData(int) const;
+    QString createAssetsProject(int);
+};
+
+#endif // EDITORBENCHMARK_H
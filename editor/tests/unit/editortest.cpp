@@ -0,0 +1,111 @@
+#include "editortest.h"
+
+#include <QtTest>
+
+#include "scene.h"
+#include "scene_manager.h"
+#include "resource_manager.h"
+#include "assetmanager.h"
+#include "gameobjectfactory.h"
+#include "fontlibrary.h"
+#include "undohistory.h"
+#include "dependencyanalyzer.h"
+#include "gotoscene.h"
+
+#define SCENE_WIDTH 640
+#define SCENE_HEIGHT 480
+
+void EditorTest::initTestCase()
+{
+    Scene::setWidth(SCENE_WIDTH);
+    Scene::setHeight(SCENE_HEIGHT);
+    GameObjectFactory::init();
+    FontLibrary::init();
+    UndoHistory::instance()->setEnabled(true);
+}
+
+void EditorTest::cleanupTestCase()
+{
+    UndoHistory::destroy();
+    AssetManager::destroy();
+    ResourceManager::destroy();
+}
+
+QVariantMap EditorTest::objectData(const QString& name) const
+{
+    QVariantMap data;
+    data.insert("type", QString("TextBox"));
+    data.insert("name", name);
+    data.insert("x", 10);
+    data.insert("y", 20);
+    data.insert("width", 50);
+    data.insert("height", 30);
+    data.insert("text", name);
+    return data;
+}
+
+//Undoing the scene's creation deletes it, redoing it creates a new one,
+//so the object has to be added back to the new scene
+void EditorTest::undoRedoRecreatedScene()
+{
+    UndoHistory* history = UndoHistory::instance();
+    history->clear();
+    SceneManager sceneManager;
+
+    Scene* scene = sceneManager.addScene("scene");
+    history->flush();
+    scene->appendObject(ResourceManager::instance()->createObject(objectData("object"), scene));
+    history->flush();
+    QCOMPARE(scene->objects().size(), 1);
+
+    history->undo();
+    QCOMPARE(sceneManager.sceneAt(0)->objects().size(), 0);
+    history->undo();
+    QCOMPARE(sceneManager.size(), 0);
+
+    history->redo();
+    QCOMPARE(sceneManager.size(), 1);
+    history->redo();
+    scene = sceneManager.sceneAt(0);
+    QCOMPARE(scene->objects().size(), 1);
+    QCOMPARE(scene->objects().first()->name(), QString("object"));
+
+    history->clear();
+}
+
+//The gallery is only reachable from a menu option on the pause screen
+void EditorTest::pauseScreenReachableScene()
+{
+    QVariantMap end;
+    end.insert("type", QString("End"));
+    QVariantMap start;
+    start.insert("name", QString("Start"));
+    start.insert("actions", QVariantList() << end);
+    QVariantMap gallery;
+    gallery.insert("name", QString("Gallery"));
+
+    QVariantMap gameData;
+    gameData.insert("scenes", QVariantList() << start << gallery);
+    QCOMPARE(DependencyAnalyzer(gameData, QStringList()).reachableScenes(), QStringList() << "Start");
+
+    QVariantMap goToScene;
+    goToScene.insert("type", QString("GoToScene"));
+    goToScene.insert("target", QString("Gallery"));
+    goToScene.insert("metaTarget", GoToScene::Name);
+    QVariantMap option = objectData("option");
+    option.insert("type", QString("MenuOption"));
+    option.insert("actions", QVariantList() << goToScene);
+    QVariantMap menu = objectData("menu");
+    menu.insert("type", QString("Menu"));
+    menu.insert("objects", QVariantList() << option);
+    QVariantMap pauseScene;
+    pauseScene.insert("name", QString("Pause"));
+    pauseScene.insert("objects", QVariantList() << menu);
+    QVariantMap pauseScreen;
+    pauseScreen.insert("scenes", QVariantList() << pauseScene);
+    gameData.insert("pauseScreen", pauseScreen);
+
+    QCOMPARE(DependencyAnalyzer(gameData, QStringList()).reachableScenes(), QStringList() << "Start" << "Gallery");
+}
+
+QTEST_MAIN(EditorTest)
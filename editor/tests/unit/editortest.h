@@ -0,0 +1,23 @@
+#ifndef EDITORTEST_H
+#define EDITORTEST_H
+
+#include <QObject>
+#include <QVariantMap>
+
+//Regression tests for the editor core
+class EditorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void undoRedoRecreatedScene();
+    void pauseScreenReachableScene();
+
+private:
+    QVariantMap objectData(const QString&) const;
+};
+
+#endif // EDITORTEST_H
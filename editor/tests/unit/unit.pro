@@ -0,0 +1,33 @@
+# QtTest unit tests for the editor core, built from the editor sources.
+# Build it in its own directory, e.g.: qmake ../editor/tests/unit/unit.pro && make check
+EDITOR_DIR = $$PWD/../..
+include($$EDITOR_DIR/belle.pro)
+
+TARGET = belle-tests
+QT += testlib
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+#belle.pro lists its files relative to the editor directory
+EDITOR_HEADERS = $$HEADERS
+EDITOR_SOURCES = $$SOURCES
+EDITOR_SOURCES -= main.cpp
+EDITOR_FORMS = $$FORMS
+EDITOR_RESOURCES = $$RESOURCES
+EDITOR_PATHS = $$INCLUDEPATH
+
+HEADERS =
+SOURCES =
+FORMS =
+RESOURCES =
+INCLUDEPATH = $$EDITOR_DIR
+DEPENDPATH = $$EDITOR_DIR
+
+for(f, EDITOR_HEADERS): HEADERS += $$EDITOR_DIR/$$f
+for(f, EDITOR_SOURCES): SOURCES += $$EDITOR_DIR/$$f
+for(f, EDITOR_FORMS): FORMS += $$EDITOR_DIR/$$f
+for(f, EDITOR_RESOURCES): RESOURCES += $$EDITOR_DIR/$$f
+for(f, EDITOR_PATHS): INCLUDEPATH += $$EDITOR_DIR/$$f
+
+HEADERS += editortest.h
+SOURCES += editortest.cpp
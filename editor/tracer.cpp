@@ -0,0 +1,123 @@
+#include "tracer.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QCoreApplication>
+
+bool Tracer::mEnabled = false;
+QMutex Tracer::mMutex;
+QElapsedTimer Tracer::mClock;
+QList<TraceEvent> Tracer::mEvents;
+QHash<quintptr, int> Tracer::mThreads;
+
+//Starts tracing right away if BELLE_TRACE is set
+void Tracer::init()
+{
+    if (! qgetenv(TRACE_ENV_VARIABLE).isEmpty())
+        setEnabled(true);
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&mMutex);
+    if (enabled && ! mClock.isValid())
+        mClock.start();
+    //tracing is turned on from the GUI thread, which is shown first
+    if (enabled && mThreads.isEmpty())
+        mThreads.insert(reinterpret_cast<quintptr>(QThread::currentThreadId()), 1);
+    mEnabled = enabled;
+}
+
+//Microseconds since tracing was first enabled
+qint64 Tracer::now()
+{
+    return mClock.nsecsElapsed() / 1000;
+}
+
+void Tracer::addEvent(const QByteArray& name, const char* category, qint64 start, qint64 duration, const QByteArray& detail)
+{
+    QMutexLocker locker(&mMutex);
+    if (mEvents.size() >= TRACE_MAX_EVENTS)
+        return;
+
+    //small thread ids are easier to read in the viewer than pointers
+    quintptr threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    if (! mThreads.contains(threadId))
+        mThreads.insert(threadId, mThreads.size() + 1);
+
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.detail = detail;
+    event.start = start;
+    event.duration = duration;
+    event.thread = mThreads.value(threadId);
+    mEvents.append(event);
+}
+
+int Tracer::eventCount()
+{
+    QMutexLocker locker(&mMutex);
+    return mEvents.size();
+}
+
+bool Tracer::save(const QString& path)
+{
+    QList<TraceEvent> events;
+    QHash<quintptr, int> threads;
+    mMutex.lock();
+    events = mEvents;
+    threads = mThreads;
+    mMutex.unlock();
+
+    qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    foreach(const TraceEvent& event, events) {
+        QJsonObject object;
+        object.insert("name", QString::fromUtf8(event.name));
+        object.insert("cat", QString::fromLatin1(event.category));
+        object.insert("ph", QString("X"));
+        object.insert("ts", double(event.start));
+        object.insert("dur", double(event.duration));
+        object.insert("pid", double(pid));
+        object.insert("tid", event.thread);
+        if (! event.detail.isEmpty()) {
+            QJsonObject args;
+            args.insert("detail", QString::fromUtf8(event.detail));
+            object.insert("args", args);
+        }
+        traceEvents.append(object);
+    }
+
+    foreach(int thread, threads.values()) {
+        QJsonObject args;
+        args.insert("name", thread == 1 ? QString("main") : QString("worker %1").arg(thread));
+        QJsonObject object;
+        object.insert("name", QString("thread_name"));
+        object.insert("ph", QString("M"));
+        object.insert("pid", double(pid));
+        object.insert("tid", thread);
+        object.insert("args", args);
+        traceEvents.append(object);
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", traceEvents);
+    trace.insert("displayTimeUnit", QString("ms"));
+
+    QFile file(path);
+    if (! file.open(QFile::WriteOnly))
+        return false;
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    file.close();
+    return true;
+}
+
+void Tracer::clear()
+{
+    QMutexLocker locker(&mMutex);
+    mEvents.clear();
+}
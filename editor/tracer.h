@@ -0,0 +1,71 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#define TRACE_ENV_VARIABLE "BELLE_TRACE"
+#define TRACE_MAX_EVENTS 1000000
+
+struct TraceEvent
+{
+    QByteArray name;
+    const char* category;
+    QByteArray detail;
+    qint64 start;
+    qint64 duration;
+    int thread;
+};
+
+//Records timed spans and writes them in the Chrome trace format (chrome://tracing or ui.perfetto.dev).
+//Turned on with the BELLE_TRACE environment variable, set to the output file, or from the Help menu.
+class Tracer
+{
+public:
+    static bool isEnabled() { return mEnabled; }
+    static void setEnabled(bool);
+    static void init();
+    static qint64 now();
+    static void addEvent(const QByteArray&, const char*, qint64, qint64, const QByteArray& detail=QByteArray());
+    static int eventCount();
+    static bool save(const QString&);
+    static void clear();
+
+private:
+    static bool mEnabled;
+    static QMutex mMutex;
+    static QElapsedTimer mClock;
+    static QList<TraceEvent> mEvents;
+    static QHash<quintptr, int> mThreads;
+};
+
+//Times the scope it's declared in; does nothing but check a flag when tracing is off.
+//Names and categories are expected to be string literals, they aren't copied.
+class TraceSpan
+{
+    const char* mName;
+    const char* mCategory;
+    QByteArray mDetail;
+    qint64 mStart;
+
+public:
+    TraceSpan(const char* name, const char* category="editor") :
+        mName(name), mCategory(category), mStart(Tracer::isEnabled() ? Tracer::now() : -1) {}
+    TraceSpan(const char* name, const char* category, const QString& detail) :
+        mName(name), mCategory(category), mStart(Tracer::isEnabled() ? Tracer::now() : -1)
+    {
+        if (mStart >= 0)
+            mDetail = detail.toUtf8();
+    }
+    ~TraceSpan()
+    {
+        if (mStart >= 0 && Tracer::isEnabled())
+            Tracer::addEvent(QByteArray::fromRawData(mName, qstrlen(mName)), mCategory, mStart, Tracer::now() - mStart, mDetail);
+    }
+};
+
+#endif // TRACER_H
@@ -0,0 +1,831 @@
+#include "undohistory.h"
+
+#include <QDateTime>
+#include <QRect>
+#include <QTimer>
+
+#include "scene.h"
+#include "scene_manager.h"
+#include "resource_manager.h"
+#include "gameobjectfactory.h"
+#include "assetmanager.h"
+#include "action.h"
+#include "object.h"
+
+static UndoHistory* mInstance = 0;
+bool UndoHistory::mRecordingBlocked = false;
+
+//rough estimate of the memory held by a value
+static qint64 variantCost(const QVariant& value)
+{
+    qint64 cost = 16;
+
+    if (value.type() == QVariant::String) {
+        cost += value.toString().size() * 2;
+    }
+    else if (value.type() == QVariant::ByteArray) {
+        cost += value.toByteArray().size();
+    }
+    else if (value.type() == QVariant::Map) {
+        QMapIterator<QString, QVariant> it(value.toMap());
+        while(it.hasNext()) {
+            it.next();
+            cost += it.key().size() * 2 + variantCost(it.value());
+        }
+    }
+    else if (value.type() == QVariant::List) {
+        QVariantList list = value.toList();
+        for(int i=0; i < list.size(); i++)
+            cost += variantCost(list.at(i));
+    }
+
+    return cost;
+}
+
+//"_object" holds the changes of the child at "_index" of an ObjectGroup
+static int childIndex(const QVariantMap& data)
+{
+    return data.value("_object").toMap().value("_index", -1).toInt();
+}
+
+static bool sameKeys(const QVariantMap& data, const QVariantMap& other)
+{
+    if (data.keys() != other.keys())
+        return false;
+
+    if (data.contains("_object"))
+        return data.value("_object").toMap().keys() == other.value("_object").toMap().keys();
+
+    return true;
+}
+
+static void mergeDelta(QVariantMap& before, QVariantMap& after, const QVariantMap& nextBefore, const QVariantMap& nextAfter)
+{
+    QMapIterator<QString, QVariant> it(nextAfter);
+    while(it.hasNext()) {
+        it.next();
+        if (it.key() == "_object" && after.contains("_object")) {
+            QVariantMap objectBefore = before.value("_object").toMap();
+            QVariantMap objectAfter = after.value("_object").toMap();
+            mergeDelta(objectBefore, objectAfter, nextBefore.value("_object").toMap(), it.value().toMap());
+            before.insert("_object", objectBefore);
+            after.insert("_object", objectAfter);
+        }
+        else {
+            if (! before.contains(it.key()))
+                before.insert(it.key(), nextBefore.value(it.key()));
+            after.insert(it.key(), it.value());
+        }
+    }
+}
+
+static void diffChildObject(QVariantMap& shadow, const QVariantMap& changes, QVariantMap& before, QVariantMap& after)
+{
+    int index = changes.value("_index", -1).toInt();
+    QVariantList objects = shadow.value("objects").toList();
+    if (index < 0 || index >= objects.size())
+        return;
+
+    QVariantMap object = objects.at(index).toMap();
+    QVariantMap objectBefore;
+    QVariantMap objectAfter;
+    QMapIterator<QString, QVariant> it(changes);
+    while(it.hasNext()) {
+        it.next();
+        if (it.key() == "_index")
+            continue;
+        if (object.contains(it.key()) && object.value(it.key()) != it.value()) {
+            objectBefore.insert(it.key(), object.value(it.key()));
+            objectAfter.insert(it.key(), it.value());
+        }
+        object.insert(it.key(), it.value());
+    }
+
+    objects[index] = object;
+    shadow.insert("objects", objects);
+
+    if (! objectBefore.isEmpty()) {
+        objectBefore.insert("_index", index);
+        objectAfter.insert("_index", index);
+        before.insert("_object", objectBefore);
+        after.insert("_object", objectAfter);
+    }
+}
+
+//"editingModeData" holds the rects of all the children of an ObjectGroup, relative to the group
+static void diffChildRects(QVariantMap& shadow, const QVariantMap& changes, QVariantMap& before, QVariantMap& after)
+{
+    QVariantList rects = changes.value("rects").toList();
+    QVariantList objects = shadow.value("objects").toList();
+    if (rects.isEmpty() || rects.size() != objects.size())
+        return;
+
+    QVariantList prevRects;
+    bool changed = false;
+    bool okX, okY, okWidth, okHeight;
+
+    for(int i=0; i < objects.size(); i++) {
+        QVariantMap object = objects.at(i).toMap();
+        QRect prevRect(object.value("relativeX").toInt(&okX), object.value("relativeY").toInt(&okY),
+                       object.value("width").toInt(&okWidth), object.value("height").toInt(&okHeight));
+        //sizes in percentage can't be restored from rects
+        if (! okX || ! okY || ! okWidth || ! okHeight)
+            return;
+
+        QRect rect = rects.at(i).toRect();
+        if (rect != prevRect)
+            changed = true;
+
+        prevRects.append(prevRect);
+        object.insert("relativeX", rect.x());
+        object.insert("relativeY", rect.y());
+        object.insert("width", rect.width());
+        object.insert("height", rect.height());
+        objects[i] = object;
+    }
+
+    shadow.insert("objects", objects);
+
+    if (changed) {
+        QVariantMap prevData;
+        prevData.insert("rects", prevRects);
+        before.insert("editingModeData", prevData);
+        after.insert("editingModeData", changes);
+    }
+}
+
+UndoCommand::UndoCommand(const QList<UndoEntry>& entries, qint64 time) :
+    QUndoCommand()
+{
+    mEntries = entries;
+    mTime = time;
+    mApplied = true;
+    updateText();
+    updateCost();
+}
+
+void UndoCommand::updateText()
+{
+    if (mEntries.isEmpty())
+        return;
+
+    //structural changes describe the command better than the property changes they cause
+    UndoEntry entry = mEntries.first();
+    for(int i=0; i < mEntries.size(); i++) {
+        if (mEntries[i].type != UndoEntry::Properties) {
+            entry = mEntries[i];
+            break;
+        }
+    }
+
+    QString name = entry.object ? entry.object->name() : entry.data.value("name").toString();
+
+    switch(entry.type) {
+    case UndoEntry::Insert:
+        setText(UndoHistory::tr("Add %1").arg(name));
+        break;
+    case UndoEntry::Remove:
+        setText(UndoHistory::tr("Remove %1").arg(name));
+        break;
+    case UndoEntry::Move:
+        setText(UndoHistory::tr("Move %1").arg(name));
+        break;
+    default:
+        setText(UndoHistory::tr("Change %1").arg(name));
+        break;
+    }
+}
+
+void UndoCommand::updateCost()
+{
+    mCost = sizeof(UndoCommand);
+    for(int i=0; i < mEntries.size(); i++) {
+        mCost += sizeof(UndoEntry);
+        mCost += variantCost(mEntries[i].before) + variantCost(mEntries[i].after) + variantCost(mEntries[i].data);
+    }
+}
+
+qint64 UndoCommand::cost() const
+{
+    return mCost;
+}
+
+UndoCommand* UndoCommand::clone() const
+{
+    UndoCommand* command = new UndoCommand(mEntries, mTime);
+    command->mApplied = mApplied;
+    return command;
+}
+
+int UndoCommand::id() const
+{
+    //only property changes are merged, e.g. while an object is dragged or a text typed
+    for(int i=0; i < mEntries.size(); i++) {
+        if (mEntries[i].type != UndoEntry::Properties)
+            return -1;
+    }
+
+    return 1;
+}
+
+bool UndoCommand::mergeWith(const QUndoCommand* other)
+{
+    const UndoCommand* command = static_cast<const UndoCommand*>(other);
+    if (UndoHistory::instance()->mTrimming || command->mEntries.size() != mEntries.size())
+        return false;
+
+    if (command->mTime - mTime > UNDO_MERGE_INTERVAL)
+        return false;
+
+    for(int i=0; i < mEntries.size(); i++) {
+        const UndoEntry& entry = mEntries[i];
+        const UndoEntry& next = command->mEntries[i];
+        if (entry.object.isNull() || entry.object != next.object || ! sameKeys(entry.after, next.after))
+            return false;
+        if (childIndex(entry.after) != childIndex(next.after))
+            return false;
+    }
+
+    for(int i=0; i < mEntries.size(); i++)
+        mEntries[i].after = command->mEntries[i].after;
+
+    mTime = command->mTime;
+    updateCost();
+    return true;
+}
+
+void UndoCommand::undo()
+{
+    UndoHistory* history = UndoHistory::instance();
+    GameObject* obj = 0;
+    GameObjectManager* manager = 0;
+
+    history->setApplying(true);
+    for(int i=mEntries.size()-1; i >= 0; --i) {
+        UndoEntry& entry = mEntries[i];
+        manager = UndoHistory::manager(entry);
+
+        switch(entry.type) {
+        case UndoEntry::Properties:
+            obj = UndoHistory::resolve(entry, entry.index);
+            if (obj)
+                obj->apply(entry.before);
+            break;
+        case UndoEntry::Insert:
+            obj = UndoHistory::resolve(entry, entry.index);
+            if (obj && manager) {
+                entry.data = UndoHistory::objectData(obj);
+                UndoHistory::removeObject(manager, obj);
+            }
+            break;
+        case UndoEntry::Remove:
+            if (manager) {
+                obj = UndoHistory::createObject(manager, entry.data);
+                if (obj) {
+                    UndoHistory::insertObject(manager, entry.index, obj);
+                    entry.object = obj;
+                }
+            }
+            break;
+        case UndoEntry::Move:
+            obj = UndoHistory::resolve(entry, entry.to);
+            if (obj && manager)
+                manager->move(obj, entry.index);
+            break;
+        }
+    }
+    history->setApplying(false);
+
+    mApplied = false;
+}
+
+void UndoCommand::redo()
+{
+    //the changes were already made when the command was recorded
+    if (mApplied)
+        return;
+
+    UndoHistory* history = UndoHistory::instance();
+    GameObject* obj = 0;
+    GameObjectManager* manager = 0;
+
+    history->setApplying(true);
+    for(int i=0; i < mEntries.size(); i++) {
+        UndoEntry& entry = mEntries[i];
+        manager = UndoHistory::manager(entry);
+
+        switch(entry.type) {
+        case UndoEntry::Properties:
+            obj = UndoHistory::resolve(entry, entry.index);
+            if (obj)
+                obj->apply(entry.after);
+            break;
+        case UndoEntry::Insert:
+            if (manager) {
+                obj = UndoHistory::createObject(manager, entry.data);
+                if (obj) {
+                    UndoHistory::insertObject(manager, entry.index, obj);
+                    entry.object = obj;
+                }
+            }
+            break;
+        case UndoEntry::Remove:
+            obj = UndoHistory::resolve(entry, entry.index);
+            if (obj && manager) {
+                entry.data = UndoHistory::objectData(obj);
+                UndoHistory::removeObject(manager, obj);
+            }
+            break;
+        case UndoEntry::Move:
+            obj = UndoHistory::resolve(entry, entry.index);
+            if (obj && manager)
+                manager->move(obj, entry.to);
+            break;
+        }
+    }
+    history->setApplying(false);
+
+    mApplied = true;
+}
+
+UndoHistory::UndoHistory(QObject *parent) :
+    QObject(parent)
+{
+    mUndoStack = new QUndoStack(this);
+    mFlushScheduled = false;
+    mEnabled = false;
+    mApplying = false;
+    mTrimming = false;
+    mMemoryBudget = UNDO_MEMORY_BUDGET;
+    mMemoryUsage = 0;
+
+    connect(mUndoStack, SIGNAL(indexChanged(int)), this, SLOT(onIndexChanged()));
+}
+
+UndoHistory::~UndoHistory()
+{
+    mUndoStack->disconnect(this);
+}
+
+UndoHistory* UndoHistory::instance()
+{
+    if (! mInstance)
+        mInstance = new UndoHistory();
+    return mInstance;
+}
+
+void UndoHistory::destroy()
+{
+    if (mInstance)
+        delete mInstance;
+    mInstance = 0;
+}
+
+QUndoStack* UndoHistory::undoStack() const
+{
+    return mUndoStack;
+}
+
+bool UndoHistory::isEnabled() const
+{
+    return mEnabled;
+}
+
+void UndoHistory::setEnabled(bool enabled)
+{
+    mEnabled = enabled;
+    if (! mEnabled) {
+        foreach(GameObject* obj, mTrackedObjects)
+            untrack(obj);
+        clear();
+    }
+}
+
+qint64 UndoHistory::memoryBudget() const
+{
+    return mMemoryBudget;
+}
+
+void UndoHistory::setMemoryBudget(qint64 budget)
+{
+    mMemoryBudget = budget;
+    if (mMemoryUsage > mMemoryBudget)
+        trim();
+}
+
+qint64 UndoHistory::memoryUsage() const
+{
+    return mMemoryUsage;
+}
+
+bool UndoHistory::blockRecording(bool block)
+{
+    bool blocked = mRecordingBlocked;
+    mRecordingBlocked = block;
+    return blocked;
+}
+
+bool UndoHistory::recordingBlocked()
+{
+    return mRecordingBlocked;
+}
+
+bool UndoHistory::isApplying() const
+{
+    return mApplying;
+}
+
+void UndoHistory::setApplying(bool applying)
+{
+    mApplying = applying;
+}
+
+bool UndoHistory::isRecording() const
+{
+    return mEnabled && ! mApplying && ! mTrimming && ! mRecordingBlocked;
+}
+
+void UndoHistory::track(GameObject* obj)
+{
+    if (! mEnabled || ! obj)
+        return;
+
+    int index = mTrackedObjects.indexOf(obj);
+    if (index != -1) {
+        mTrackedObjects.move(index, mTrackedObjects.size()-1);
+        return;
+    }
+
+    QVariantMap shadow = objectData(obj);
+    //scenes don't report changes to their objects and actions as properties
+    if (obj->type() == GameObjectMetaType::Scene) {
+        shadow.remove("objects");
+        shadow.remove("actions");
+    }
+
+    mShadows.insert(obj, shadow);
+    mTrackedObjects.append(obj);
+    connect(obj, SIGNAL(dataChanged(const QVariantMap&)), this, SLOT(onTrackedObjectChanged(const QVariantMap&)));
+    connect(obj, SIGNAL(destroyed(GameObject*)), this, SLOT(onTrackedObjectDestroyed(GameObject*)));
+
+    while(mTrackedObjects.size() > UNDO_MAX_TRACKED_OBJECTS)
+        untrack(mTrackedObjects.first());
+}
+
+void UndoHistory::untrack(GameObject* obj)
+{
+    if (! obj)
+        return;
+
+    obj->disconnect(this);
+    mShadows.remove(obj);
+    mTrackedObjects.removeAll(obj);
+}
+
+void UndoHistory::watch(GameObjectManager* manager)
+{
+    if (! manager)
+        return;
+
+    connect(manager, SIGNAL(objectInserted(int, GameObject*)), this, SLOT(onObjectInserted(int, GameObject*)), Qt::UniqueConnection);
+    connect(manager, SIGNAL(objectAboutToBeTaken(int, GameObject*)), this, SLOT(onObjectAboutToBeTaken(int, GameObject*)), Qt::UniqueConnection);
+    connect(manager, SIGNAL(objectMoved(GameObject*, int, int)), this, SLOT(onObjectMoved(GameObject*, int, int)), Qt::UniqueConnection);
+}
+
+void UndoHistory::onTrackedObjectChanged(const QVariantMap& data)
+{
+    GameObject* obj = qobject_cast<GameObject*>(sender());
+    if (! obj || data.isEmpty() || ! mShadows.contains(obj))
+        return;
+
+    //the last values are kept up to date even when not recording, e.g. while undoing
+    QVariantMap& shadow = mShadows[obj];
+    QVariantMap before;
+    QVariantMap after;
+    QMapIterator<QString, QVariant> it(data);
+
+    while(it.hasNext()) {
+        it.next();
+        if (it.key() == "_object") {
+            diffChildObject(shadow, it.value().toMap(), before, after);
+        }
+        else if (it.key() == "editingModeData") {
+            diffChildRects(shadow, it.value().toMap(), before, after);
+        }
+        else {
+            //values the object didn't serialize before can't be restored
+            if (shadow.contains(it.key()) && shadow.value(it.key()) != it.value()) {
+                before.insert(it.key(), shadow.value(it.key()));
+                after.insert(it.key(), it.value());
+            }
+            shadow.insert(it.key(), it.value());
+        }
+    }
+
+    if (! before.isEmpty() && isRecording())
+        addProperties(obj, before, after);
+}
+
+void UndoHistory::onTrackedObjectDestroyed(GameObject* obj)
+{
+    mShadows.remove(obj);
+    mTrackedObjects.removeAll(obj);
+}
+
+void UndoHistory::addProperties(GameObject* obj, const QVariantMap& before, const QVariantMap& after)
+{
+    //several notifications from the same object in one pass become one entry
+    if (! mPendingEntries.isEmpty()) {
+        UndoEntry& last = mPendingEntries.last();
+        if (last.type == UndoEntry::Properties && last.object == obj &&
+            (! last.after.contains("_object") || ! after.contains("_object") || childIndex(last.after) == childIndex(after))) {
+            mergeDelta(last.before, last.after, before, after);
+            return;
+        }
+    }
+
+    UndoEntry entry;
+    entry.type = UndoEntry::Properties;
+    entry.object = obj;
+    setManager(entry, obj->manager());
+    if (entry.manager)
+        entry.index = entry.manager->indexOf(obj);
+    entry.before = before;
+    entry.after = after;
+    addEntry(entry);
+}
+
+void UndoHistory::onObjectInserted(int index, GameObject* obj)
+{
+    GameObjectManager* manager = qobject_cast<GameObjectManager*>(sender());
+    if (! obj || ! manager || ! isRecording())
+        return;
+
+    UndoEntry entry;
+    entry.type = UndoEntry::Insert;
+    entry.object = obj;
+    setManager(entry, manager);
+    entry.index = index;
+    addEntry(entry);
+}
+
+void UndoHistory::onObjectAboutToBeTaken(int index, GameObject* obj)
+{
+    GameObjectManager* manager = qobject_cast<GameObjectManager*>(sender());
+    if (! obj || ! manager || ! isRecording())
+        return;
+
+    UndoEntry entry;
+    entry.type = UndoEntry::Remove;
+    entry.object = obj;
+    setManager(entry, manager);
+    entry.index = index;
+    entry.data = objectData(obj);
+    addEntry(entry);
+}
+
+void UndoHistory::onObjectMoved(GameObject* obj, int from, int to)
+{
+    GameObjectManager* manager = qobject_cast<GameObjectManager*>(sender());
+    if (! obj || ! manager || ! isRecording())
+        return;
+
+    UndoEntry entry;
+    entry.type = UndoEntry::Move;
+    entry.object = obj;
+    setManager(entry, manager);
+    entry.index = from;
+    entry.to = to;
+    addEntry(entry);
+}
+
+void UndoHistory::addEntry(const UndoEntry& entry)
+{
+    //an object taken out and inserted again in the same manager was only moved
+    if (entry.type == UndoEntry::Insert && ! mPendingEntries.isEmpty()) {
+        UndoEntry& last = mPendingEntries.last();
+        if (last.type == UndoEntry::Remove && last.object == entry.object && last.manager == entry.manager) {
+            last.type = UndoEntry::Move;
+            last.to = entry.index;
+            last.data.clear();
+            if (last.index == last.to)
+                mPendingEntries.removeLast();
+            return;
+        }
+    }
+
+    mPendingEntries.append(entry);
+
+    //everything that changes until control returns to the event loop is undone at once
+    if (! mFlushScheduled) {
+        mFlushScheduled = true;
+        QTimer::singleShot(0, this, SLOT(flush()));
+    }
+}
+
+void UndoHistory::flush()
+{
+    mFlushScheduled = false;
+    if (mPendingEntries.isEmpty())
+        return;
+
+    QList<UndoEntry> entries = mPendingEntries;
+    mPendingEntries.clear();
+    if (! mEnabled)
+        return;
+
+    mUndoStack->push(new UndoCommand(entries, QDateTime::currentMSecsSinceEpoch()));
+    onIndexChanged();
+
+    if (mMemoryUsage > mMemoryBudget)
+        trim();
+}
+
+//QUndoStack can't drop its oldest commands, so copies of the newest ones
+//that fit in three quarters of the budget are pushed to the cleared stack.
+//The commands that could be redone are dropped as well.
+void UndoHistory::trim()
+{
+    int index = mUndoStack->index();
+    qint64 budget = mMemoryBudget * 3 / 4;
+    qint64 cost = 0;
+    int first = index;
+
+    while(first > 0) {
+        const UndoCommand* command = static_cast<const UndoCommand*>(mUndoStack->command(first-1));
+        //the last change is always kept
+        if (first < index && cost + command->cost() > budget)
+            break;
+        cost += command->cost();
+        first--;
+    }
+
+    QList<UndoCommand*> commands;
+    for(int i=first; i < index; i++)
+        commands.append(static_cast<const UndoCommand*>(mUndoStack->command(i))->clone());
+
+    mTrimming = true;
+    mUndoStack->clear();
+    foreach(UndoCommand* command, commands)
+        mUndoStack->push(command);
+    mTrimming = false;
+
+    onIndexChanged();
+}
+
+void UndoHistory::undo()
+{
+    flush();
+    if (! mUndoStack->canUndo())
+        return;
+
+    mUndoStack->undo();
+    emit applied();
+}
+
+void UndoHistory::redo()
+{
+    flush();
+    if (! mUndoStack->canRedo())
+        return;
+
+    mUndoStack->redo();
+    emit applied();
+}
+
+void UndoHistory::clear()
+{
+    mPendingEntries.clear();
+    mUndoStack->clear();
+    onIndexChanged();
+}
+
+void UndoHistory::onIndexChanged()
+{
+    if (mTrimming)
+        return;
+
+    mMemoryUsage = 0;
+    for(int i=0; i < mUndoStack->count(); i++)
+        mMemoryUsage += static_cast<const UndoCommand*>(mUndoStack->command(i))->cost();
+
+    //removed assets may still be brought back
+    AssetManager::instance()->setKeepRemovedFiles(mUndoStack->count() > 0);
+}
+
+QVariantMap UndoHistory::objectData(GameObject* obj)
+{
+    //Scene::toJsonObject isn't an override of GameObject::toJsonObject
+    Scene* scene = qobject_cast<Scene*>(obj);
+    if (scene)
+        return scene->toJsonObject();
+    return obj->toJsonObject();
+}
+
+void UndoHistory::setManager(UndoEntry& entry, GameObjectManager* manager)
+{
+    entry.manager = manager;
+    Scene* scene = manager ? qobject_cast<Scene*>(manager->objectsParent()) : 0;
+    SceneManager* sceneManager = scene ? scene->sceneManager() : 0;
+    if (! sceneManager)
+        return;
+
+    entry.sceneManager = sceneManager;
+    entry.sceneIndex = sceneManager->indexOf(scene);
+    entry.sceneActions = (manager == scene->actionManager());
+}
+
+GameObjectManager* UndoHistory::manager(const UndoEntry& entry)
+{
+    if (entry.manager)
+        return entry.manager;
+
+    //the scene was deleted and recreated since the entry was recorded
+    if (! entry.sceneManager)
+        return 0;
+
+    Scene* scene = entry.sceneManager->sceneAt(entry.sceneIndex);
+    if (! scene)
+        return 0;
+
+    return entry.sceneActions ? scene->actionManager() : scene->objectManager();
+}
+
+GameObject* UndoHistory::resolve(const UndoEntry& entry, int index)
+{
+    if (entry.object)
+        return entry.object;
+
+    GameObjectManager* manager = UndoHistory::manager(entry);
+    if (! manager)
+        return 0;
+
+    Scene* scene = qobject_cast<Scene*>(manager->objectsParent());
+    if (scene && ! scene->isLoaded())
+        scene->load();
+
+    return manager->objectAt(index);
+}
+
+GameObject* UndoHistory::createObject(GameObjectManager* manager, const QVariantMap& data)
+{
+    if (data.isEmpty())
+        return 0;
+
+    QObject* owner = manager->objectsParent();
+    Scene* scene = qobject_cast<Scene*>(owner);
+
+    if (scene && manager == scene->actionManager())
+        return GameObjectFactory::createAction(data, scene);
+    if (scene)
+        return ResourceManager::instance()->createObject(data, scene);
+    if (qobject_cast<SceneManager*>(owner))
+        return GameObjectFactory::createScene(data, owner);
+    if (manager == ResourceManager::instance())
+        return ResourceManager::instance()->createGameObject(data, ResourceManager::instance());
+
+    return GameObjectFactory::createGameObject(data, owner);
+}
+
+//Scenes and their owners do extra work when objects are added or removed,
+//so their own methods are used instead of the manager's.
+void UndoHistory::insertObject(GameObjectManager* manager, int index, GameObject* obj)
+{
+    QObject* owner = manager->objectsParent();
+    Scene* scene = qobject_cast<Scene*>(owner);
+    SceneManager* sceneManager = qobject_cast<SceneManager*>(owner);
+
+    if (scene && manager == scene->actionManager()) {
+        scene->insertAction(index, qobject_cast<Action*>(obj));
+    }
+    else if (scene) {
+        scene->appendObject(qobject_cast<Object*>(obj), false);
+        manager->move(obj, index);
+    }
+    else if (sceneManager) {
+        sceneManager->insertScene(index, qobject_cast<Scene*>(obj));
+    }
+    else {
+        if (manager == ResourceManager::instance())
+            ResourceManager::instance()->add(obj);
+        else
+            manager->add(obj);
+        manager->move(obj, index);
+    }
+}
+
+void UndoHistory::removeObject(GameObjectManager* manager, GameObject* obj)
+{
+    QObject* owner = manager->objectsParent();
+    Scene* scene = qobject_cast<Scene*>(owner);
+    SceneManager* sceneManager = qobject_cast<SceneManager*>(owner);
+
+    if (scene && manager == scene->actionManager())
+        scene->removeAction(qobject_cast<Action*>(obj), true);
+    else if (scene)
+        scene->removeObject(qobject_cast<Object*>(obj), true);
+    else if (sceneManager)
+        sceneManager->removeScene(qobject_cast<Scene*>(obj), true);
+    else
+        manager->remove(obj, true);
+}
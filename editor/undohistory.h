@@ -0,0 +1,153 @@
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QUndoStack>
+#include <QVariantMap>
+
+#include "gameobject.h"
+#include "gameobjectmanager.h"
+
+class SceneManager;
+
+#define UNDO_MEMORY_BUDGET 32*1024*1024
+#define UNDO_MERGE_INTERVAL 1000
+#define UNDO_MAX_TRACKED_OBJECTS 32
+
+//A single recorded change: some properties of an object, or an object inserted into,
+//removed from or moved inside a GameObjectManager.
+struct UndoEntry
+{
+    enum Type {
+        Properties,
+        Insert,
+        Remove,
+        Move
+    };
+
+    Type type;
+    QPointer<GameObject> object;
+    //used to find the object again after it was deleted and recreated
+    QPointer<GameObjectManager> manager;
+    //undo and redo can delete and recreate a scene along with its managers,
+    //so those are found again through the scene's position in its SceneManager
+    QPointer<SceneManager> sceneManager;
+    int sceneIndex;
+    bool sceneActions;
+    int index;
+    int to;
+    QVariantMap before;
+    QVariantMap after;
+    //the serialized object, for insertions and removals
+    QVariantMap data;
+    UndoEntry() : type(Properties), sceneIndex(-1), sceneActions(false), index(-1), to(-1) {}
+};
+
+//All the changes recorded during one pass of the event loop
+class UndoCommand : public QUndoCommand
+{
+public:
+    UndoCommand(const QList<UndoEntry>&, qint64 time);
+
+    virtual int id() const;
+    virtual bool mergeWith(const QUndoCommand*);
+    virtual void undo();
+    virtual void redo();
+
+    qint64 cost() const;
+    UndoCommand* clone() const;
+
+private:
+    void updateText();
+    void updateCost();
+
+    QList<UndoEntry> mEntries;
+    qint64 mTime;
+    qint64 mCost;
+    bool mApplied;
+};
+
+//Records changes as property level deltas instead of snapshots of the project.
+//Only the objects being edited are tracked, keeping the last values they reported,
+//so the cost of recording doesn't depend on the size of the project.
+//Structural changes come from the watched managers. Commands recorded within
+//UNDO_MERGE_INTERVAL of each other for the same properties are merged, and the oldest
+//commands are dropped once the estimated memory use goes over the budget.
+class UndoHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    static UndoHistory* instance();
+    static void destroy();
+
+    QUndoStack* undoStack() const;
+
+    bool isEnabled() const;
+    void setEnabled(bool);
+
+    qint64 memoryBudget() const;
+    void setMemoryBudget(qint64);
+    qint64 memoryUsage() const;
+
+    void track(GameObject*);
+    void watch(GameObjectManager*);
+
+    static bool blockRecording(bool);
+    static bool recordingBlocked();
+    bool isApplying() const;
+
+public slots:
+    void undo();
+    void redo();
+    void clear();
+    void flush();
+
+signals:
+    void applied();
+
+private slots:
+    void onTrackedObjectChanged(const QVariantMap&);
+    void onTrackedObjectDestroyed(GameObject*);
+    void onObjectInserted(int, GameObject*);
+    void onObjectAboutToBeTaken(int, GameObject*);
+    void onObjectMoved(GameObject*, int, int);
+    void onIndexChanged();
+
+private:
+    explicit UndoHistory(QObject *parent = 0);
+    virtual ~UndoHistory();
+    bool isRecording() const;
+    void addEntry(const UndoEntry&);
+    void addProperties(GameObject*, const QVariantMap&, const QVariantMap&);
+    void untrack(GameObject*);
+    void trim();
+
+    friend class UndoCommand;
+    static QVariantMap objectData(GameObject*);
+    static void setManager(UndoEntry&, GameObjectManager*);
+    static GameObjectManager* manager(const UndoEntry&);
+    static GameObject* resolve(const UndoEntry&, int);
+    static GameObject* createObject(GameObjectManager*, const QVariantMap&);
+    static void insertObject(GameObjectManager*, int, GameObject*);
+    static void removeObject(GameObjectManager*, GameObject*);
+    void setApplying(bool);
+
+private:
+    QUndoStack* mUndoStack;
+    QHash<GameObject*, QVariantMap> mShadows;
+    QList<GameObject*> mTrackedObjects;
+    QList<UndoEntry> mPendingEntries;
+    bool mFlushScheduled;
+    bool mEnabled;
+    bool mApplying;
+    bool mTrimming;
+    qint64 mMemoryBudget;
+    qint64 mMemoryUsage;
+    static bool mRecordingBlocked;
+};
+
+#endif // UNDOHISTORY_H
@@ -936,6 +936,7 @@ function Branch(data, parent)
     this.condition = "";
     this.trueActions = [];
     this.falseActions = [];
+    this._test = null;
     this._actionGroup = null;
     this.result = null;
     var action;
@@ -960,6 +961,17 @@ function Branch(data, parent)
     }
 
     this.condition = ConditionTokenFactory.createCondition(data["condition"]);
+
+    //compiled by the editor when exporting, avoids interpreting the condition every time
+    if (typeof data["compiledCondition"] == "string") {
+      try {
+        this._test = new Function("v", "return " + data["compiledCondition"] + ";");
+      }
+      catch(e) {
+        belle.log("Invalid compiled condition: " + data["compiledCondition"]);
+        this._test = null;
+      }
+    }
 }
 
 belle.extend(Branch, Action);
@@ -974,7 +986,15 @@ Branch.prototype.onExecute = function()
 
   this.result = null;
 
-  if (this.condition)
+  if (this._test) {
+    try {
+      this.result = this._test(game.variables) === true;
+    }
+    catch(e) {
+      this.result = false;
+    }
+  }
+  else if (this.condition)
     this.result = this.condition.eval(game.variables);
 
   var actions = (this.result === true) ? this.trueActions : this.falseActions;
@@ -26,6 +26,7 @@
   {
     CoreObject.call(this);
     this.loadedAssets = [];
+    this.atlases = [];
     this.assets = {};
     this.assetsRefCount = {};
     this.load(data);
@@ -43,6 +44,9 @@
     };
     
     this.data = data;
+    this.aliases = {};
+    this.manifests = {};
+    this.prefetch = {};
 
     if (! data) {
       this.trigger("loaded");
@@ -53,17 +57,32 @@
     this.typeToPath["Image"] = subdirs["images"];
     this.typeToPath["Audio"] = subdirs["sounds"];
     this.typeToPath["Font"] = subdirs["fonts"];
+    //names of duplicated files that were only exported once
+    this.aliases = data["aliases"] || {};
+    //assets needed by each scene; only the ones in the preload list are loaded before the game starts
+    this.manifests = data["manifests"] || {};
+    this.prefetch = data["prefetch"] || {};
+    var preload = data["preload"] instanceof Array ? data["preload"] : null;
 
     var images = data["images"] || [];
     var sounds = data["sounds"] || [];
     var fonts = data["fonts"] || [];
+    var atlases = data["atlases"] || [];
+
+    //images packed together by the editor, shared by all the assets inside them
+    this.atlases = [];
+    for(var i=0; i < atlases.length; i++) {
+      var atlas = new window.Image();
+      atlas.src = this.getFilePath(atlases[i], "Image");
+      this.atlases.push(atlas);
+    }
 
     for(var i=0; i < images.length; i++) {
-      this._loadAsset(images[i], "Image");
+      this._loadAsset(images[i], "Image", preload && preload.indexOf(images[i].name) == -1);
     }
 
     for(var i=0; i < sounds.length; i++) {
-      this._loadAsset(sounds[i], "Audio");
+      this._loadAsset(sounds[i], "Audio", preload && preload.indexOf(sounds[i].name) == -1);
     }
 
     for(var i=0; i < fonts.length; i++) {
@@ -93,7 +112,7 @@
     return this._loadAsset(data, type);
   }
 
-  AssetManager.prototype._loadAsset = function(data, type)
+  AssetManager.prototype._loadAsset = function(data, type, deferred)
   {
     var self = this,
         asset = null,
@@ -108,28 +127,37 @@
 
     if (type == "image") {
       if ("frames" in data) {
-        asset = new belle.graphics.AnimatedImage(path, data.frames, function(){
+        var frames = [];
+        for(var i=0; i < data.frames.length; i++)
+          frames.push(this._atlasFrame(data.frames[i]));
+        asset = new belle.graphics.AnimatedImage(path, frames, function(){
                                                       self.assetLoaded(this);
                                                   });
       }
       else if (path) {
+        var atlasFrame = this._atlasFrame(data);
+        //images in atlases are downloaded with the atlas, so they can't be deferred
+        if (atlasFrame.element)
+          deferred = false;
         asset = new belle.graphics.Image(path, function(){
                                       self.assetLoaded(this);
-                                    });
+                                    }, atlasFrame.element ? atlasFrame : null, deferred);
       }
     }
     else if (type == "audio" || type == "sound" || type == "music") {
       var src = data.sources ? this.getFilePaths(data.sources, type) : path;
       asset = new buzz.sound(src, {
-                      preload: true
+                      preload: ! deferred
                   });
       asset.name = name;
       asset.bind('canplay error', function() {
         self.assetLoaded(this);
       });
       
-      if (! buzz.isSupported())
+      if (! buzz.isSupported()) {
+        deferred = false;
         this.assetLoaded(asset);
+      }
     }
     else if (type == "font") {
       asset = data;
@@ -137,6 +165,8 @@
     }
 
     if (asset) {
+      if (deferred)
+        asset._deferred = true;
       this.assets[path] = asset;
       this.assetsRefCount[path] = 1;
     }
@@ -144,6 +174,44 @@
     return asset;
   }
 
+  //Starts downloading an asset that was left out of the initial load
+  AssetManager.prototype.fetchAsset = function(asset)
+  {
+    if (! asset || ! asset._deferred)
+      return;
+
+    asset._deferred = false;
+    asset._prefetched = true;
+    if (typeof asset.fetch == "function")
+      asset.fetch();
+    else if (typeof asset.load == "function")
+      asset.load();
+  }
+
+  //Fetches the assets of the given scene and of the scenes that can follow it
+  AssetManager.prototype.prefetchScene = function(name)
+  {
+    var scenes = [name].concat(this.prefetch[name] || []);
+
+    for(var i=0; i < scenes.length; i++) {
+      var names = this.manifests[scenes[i]] || [];
+      for(var j=0; j < names.length; j++) {
+        var asset = this.assets[this.getFilePath(names[j], "Image")] || this.assets[this.getFilePath(names[j], "Audio")];
+        this.fetchAsset(asset);
+      }
+    }
+  }
+
+  AssetManager.prototype._atlasFrame = function(data)
+  {
+    if (typeof data.atlas != "number" || ! this.atlases[data.atlas])
+      return data;
+
+    var frame = jQuery.extend({}, data);
+    frame.element = this.atlases[data.atlas];
+    return frame;
+  }
+
   AssetManager.prototype._loadFont = function(data)
   {
     var _data = {},
@@ -208,7 +276,8 @@
       assets = this.loadedAssets;
     else {
       for(var path in this.assets)
-        assets.push(this.assets[path]);
+        if (! this.assets[path]._deferred)
+          assets.push(this.assets[path]);
     }
     return assets;
   }
@@ -224,6 +293,15 @@
       return;
 
     this.loadedAssets.push(asset);
+
+    //assets fetched while the game runs don't restart it
+    if (asset._prefetched) {
+      this.trigger("assetPrefetched", {
+        asset: asset
+      });
+      return;
+    }
+
     this.trigger("assetLoaded", {
       asset: asset,
       loaded: this.loadedAssets.length,
@@ -260,6 +338,8 @@
 
   AssetManager.prototype.getFilePath = function(name, type)
   {
+    if (this.aliases && name in this.aliases)
+      name = this.aliases[name];
     if (! type)
       type = guessType(name);
     type = type.toLowerCase();
@@ -307,6 +307,12 @@
     this.update();
   }
 
+  //Whether the asset is drawn by this frame, so it can be repainted once the asset loads
+  Frame.prototype.usesAsset = function(asset)
+  {
+    return asset ? this.background.image == asset : false;
+  }
+
   Frame.prototype.setBackgroundColor = function(color)
   {
     if (this.background.color == color)
@@ -339,7 +345,7 @@
     }
 
     if (this.background.image) {
-      ctx.drawImage(this.background.image.getElement(), x, y, this.width, this.height);
+      this.background.image.draw(ctx, x, y, this.width, this.height);
       this.background.image.update();
     }
 
@@ -208,6 +208,42 @@
     return belle.createObject(data, parent);
   }
 
+  //Applies the changes sent by the editor to a running preview
+  Game.prototype.applyUpdate = function(update) {
+    var resources = update.resources || {},
+        removed = update.removedResources || [];
+
+    if (! this.data.resources)
+      this.data.resources = {};
+
+    for(var name in resources) {
+      this.data.resources[name] = resources[name];
+      var obj = belle.createObject(resources[name], this);
+      if (obj)
+        this.resources[name] = obj;
+    }
+
+    for(var i=0; i < removed.length; i++) {
+      delete this.data.resources[removed[i]];
+      delete this.resources[removed[i]];
+    }
+
+    if (update.manifests)
+      this.assetManager.manifests = update.manifests;
+    if (update.prefetch)
+      this.assetManager.prefetch = update.prefetch;
+    //the pause screen may use assets that weren't loaded before
+    var preload = update.preload || [];
+    for(var i=0; i < preload.length; i++)
+      this.assetManager.fetchAsset(this.assetManager.assets[this.assetManager.getFilePath(preload[i], "Image")] ||
+                                   this.assetManager.assets[this.assetManager.getFilePath(preload[i], "Audio")]);
+
+    if (this.mainModel)
+      this.mainModel.patchScenes(update.scenes, update.sceneOrder);
+    if (this.pauseModel)
+      this.pauseModel.patchScenes(update.pauseScenes, update.pauseSceneOrder);
+  }
+
   Game.prototype.createAction = function(data, parent) {
     return belle.createAction(data, parent);
   }
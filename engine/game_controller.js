@@ -53,6 +53,33 @@
       this.game.resume();
     else
       this.setView("load");
+
+    //previews run by the editor receive its changes while running
+    if (this.game.getProperty("livePreview"))
+      this.connectToEditor();
+  }
+
+  GameController.prototype.connectToEditor = function()
+  {
+    if (! window.EventSource)
+      return;
+
+    var controller = this,
+        events = new EventSource("__belle/events");
+
+    events.addEventListener("update", function(e) {
+      try {
+        controller.game.applyUpdate(JSON.parse(e.data));
+      }
+      catch(error) {
+        belle.log("Couldn't apply the editor's changes: " + error);
+        window.location.reload();
+      }
+    });
+
+    events.addEventListener("reload", function(e) {
+      window.location.reload();
+    });
   }
 
   GameController.prototype.setupGameEvents = function()
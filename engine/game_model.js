@@ -68,6 +68,11 @@
   GameModel.prototype._setGameProperties = function(data) {
     this.resources = data.resources;
     this.assetManager = data.assetManager;
+    //assets that weren't preloaded can finish loading after the scene was painted
+    if (this.assetManager)
+      this.assetManager.bind("assetPrefetched", this, function(data) {
+        this._assetPrefetched(data.asset);
+      }, true);
     this.soundManager = data.soundManager;
     this.properties = data.properties;
   }
@@ -153,6 +158,9 @@
 
       this.scene = scene;
       this._nextScene = null;
+      //start downloading what this scene and the ones after it need
+      if (this.assetManager)
+        this.assetManager.prefetchScene(scene.name);
       this.scene.show();
       this.trigger("sceneChanged");
       //TODO: In the future use event for when scene is ready
@@ -163,6 +171,80 @@
     }
   }
 
+  GameModel.prototype._assetPrefetched = function(asset) {
+    var scene = this.scene;
+    if (! scene)
+      return;
+
+    if (scene.usesAsset(asset))
+      scene.redraw = true;
+
+    var objects = scene.getObjects();
+    for(var i=0; i < objects.length; i++) {
+      if (objects[i].usesAsset(asset))
+        objects[i].redraw = true;
+    }
+  }
+
+  //Replaces the given scenes and, if an order is given, adds or removes scenes to match it.
+  //The current scene is restarted when it changed.
+  GameModel.prototype.patchScenes = function(scenes, order) {
+    if (! scenes && ! order)
+      return;
+
+    var SceneClass = belle["Scene"],
+        replaced = {},
+        current = this.getScene(),
+        i;
+
+    scenes = scenes || [];
+    for(i=0; i < scenes.length; i++) {
+      var data = scenes[i];
+      if (belle[data.type] != SceneClass)
+        continue;
+      data.width = this.properties.width;
+      data.height = this.properties.height;
+      replaced[data.name] = new SceneClass(data, this);
+    }
+
+    var names = order || [];
+    if (! order) {
+      for(i=0; i < this.scenes.length; i++)
+        names.push(this.scenes[i].name);
+    }
+
+    var patched = [];
+    for(i=0; i < names.length; i++) {
+      var scene = replaced[names[i]] || this.getScene(names[i]);
+      if (scene)
+        patched.push(scene);
+    }
+    this.scenes = patched;
+
+    if (this.data) {
+      var dataScenes = [];
+      for(i=0; i < patched.length; i++)
+        dataScenes.push(patched[i].name in replaced ? this._findSceneData(scenes, patched[i].name) : this.getSceneData(patched[i].name));
+      this.data.scenes = dataScenes;
+    }
+
+    if (current && (current.name in replaced || this.scenes.indexOf(current) == -1)) {
+      var restarted = this.getScene(current.name) || this.scenes[0] || null;
+      current.unbind("finished", this);
+      current.hide();
+      this.scene = null;
+      if (restarted && ! this.isFinished())
+        this.setScene(restarted);
+    }
+  }
+
+  GameModel.prototype._findSceneData = function(scenes, name) {
+    for(var i=0; i < scenes.length; i++)
+      if (scenes[i].name == name)
+        return scenes[i];
+    return {};
+  }
+
   GameModel.prototype.getScenes = function() {
     return this.scenes;
   }
@@ -22,22 +22,51 @@
 
   /*** Image ***/
 
-  function Image(path, loadCallback)
+  function Image(path, loadCallback, atlasFrame, deferred)
   {
     Asset.call(this, path);
+    var self = this;
+    this.rect = null;
+
+    //image packed in an atlas, which is shared with other images
+    if (atlasFrame) {
+      this._image = atlasFrame.element;
+      this.rect = atlasFrame.rect;
+      if (loadCallback && typeof loadCallback == "function") {
+        if (this._image.complete) {
+          setTimeout(function() {
+            loadCallback.call(self);
+          }, 0);
+        }
+        else {
+          this._image.addEventListener("load", function() {
+            loadCallback.call(self);
+          });
+        }
+      }
+      return;
+    }
 
     this._image = new window.Image();
     if (loadCallback && typeof loadCallback == "function") {
-      var self = this;
       this._image.onload = function() {
         loadCallback.call(self);
       };
     }
-    this._image.src = path;
+
+    //deferred images are only downloaded when fetch is called
+    if (! deferred)
+      this._image.src = path;
   }
 
   belle.extend(Image, Asset);
 
+  Image.prototype.fetch = function()
+  {
+    if (! this._image.getAttribute("src"))
+      this._image.src = this.getPath();
+  }
+
   Image.prototype.isAnimated = function()
   {
     return false;
@@ -48,6 +77,20 @@
     return this._image;
   }
 
+  Image.prototype.getRect = function()
+  {
+    return this.rect;
+  }
+
+  Image.prototype.draw = function(context, x, y, width, height)
+  {
+    var rect = this.getRect();
+    if (rect)
+      context.drawImage(this.getElement(), rect[0], rect[1], rect[2], rect[3], x, y, width, height);
+    else
+      context.drawImage(this.getElement(), x, y, width, height);
+  }
+
   Image.prototype.update = function()
   {
   }
@@ -66,10 +109,14 @@
     this._updateFrameOnPaint = false;
 
     for(var i=0; i < frames.length; i++) {
-      var img = new window.Image();
-      img.src = frames[i]["data"];
+      var img = frames[i]["element"];
+      if (! img) {
+        img = new window.Image();
+        img.src = frames[i]["data"];
+      }
       var entry = {
         "img" : img,
+        "rect" : frames[i]["rect"] || null,
         "delay" : frames[i]["delay"]
       };
       this.frames.push(entry);
@@ -137,6 +184,11 @@
     return this.currentFrame["img"];
   }
 
+  AnimatedImage.prototype.getRect = function()
+  {
+    return this.currentFrame ? this.currentFrame["rect"] : null;
+  }
+
   AnimatedImage.prototype.update = function()
   {
     this._painted = true;
@@ -463,6 +463,13 @@ Image.prototype.setImage = function(img)
   assetManager.releaseAsset(oldImg);
 }
 
+Image.prototype.usesAsset = function(asset)
+{
+  if (Object.prototype.usesAsset.call(this, asset))
+    return true;
+  return asset ? this.image == asset : false;
+}
+
 Image.prototype.paint = function(context)
 {
     if (! this.visible)
@@ -471,7 +478,7 @@ Image.prototype.paint = function(context)
     Object.prototype.paint.call(this, context);
 
     if (this.image) {
-      context.drawImage(this.image.getElement(), this.globalX(), this.globalY(), this.width, this.height);
+      this.image.draw(context, this.globalX(), this.globalY(), this.width, this.height);
       this.image.update();
     }
 }
@@ -936,6 +943,19 @@ ObjectGroup.prototype.clear = function (context)
   }
 }
 
+ObjectGroup.prototype.usesAsset = function(asset)
+{
+  if (Object.prototype.usesAsset.call(this, asset))
+    return true;
+
+  for (var i=0; i !== this.objects.length; i++) {
+    if (this.objects[i].usesAsset(asset))
+      return true;
+  }
+
+  return false;
+}
+
 ObjectGroup.prototype.needsRedraw = function()
 {
     for (var i=0; i !== this.objects.length; i++) {
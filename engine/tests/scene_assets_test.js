@@ -0,0 +1,156 @@
+/* Runs the engine's model code in node with stand-ins for the browser.
+ * Usage: node engine/tests/scene_assets_test.js
+ */
+
+var vm = require("vm"),
+    fs = require("fs"),
+    path = require("path"),
+    assert = require("assert");
+
+var engineDir = path.join(__dirname, ".."),
+    scripts = ["init.js", "utils.js", "core.js", "asset_manager.js", "graphics.js", "game_object.js",
+               "frame.js", "objects.js", "actions.js", "scene.js", "game_model.js", "sound_manager.js", "game.js"];
+
+//images only "download" when their source is set, like deferred images in the browser
+function FakeImage() {
+  this.complete = false;
+  this.attributes = {};
+}
+
+FakeImage.prototype.getAttribute = function(name) {
+  return this.attributes[name];
+};
+
+Object.defineProperty(FakeImage.prototype, "src", {
+  get: function() { return this.attributes.src; },
+  set: function(src) {
+    var self = this;
+    this.attributes.src = src;
+    setTimeout(function() {
+      self.complete = true;
+      if (self.onload)
+        self.onload();
+    }, 0);
+  }
+});
+
+function createContext() {
+  var context = {
+    setTimeout: setTimeout,
+    clearTimeout: clearTimeout,
+    setInterval: setInterval,
+    clearInterval: clearInterval,
+    console: console,
+    document: {
+      getElementById: function() { return null; },
+      createElement: function() { return {style: {}}; }
+    },
+    buzz: {
+      isSupported: function() { return false; },
+      sound: function() { this.bind = function() {}; }
+    },
+    FontFaceObserver: function() {
+      this.load = function() { return {then: function() {}}; };
+    },
+    jQuery: {
+      extend: function(target) {
+        for(var i=1; i < arguments.length; i++)
+          for(var key in arguments[i])
+            target[key] = arguments[i][key];
+        return target;
+      }
+    }
+  };
+  context.window = context;
+  context.window.Image = FakeImage;
+  context.$ = context.jQuery;
+  vm.createContext(context);
+
+  for(var i=0; i < scripts.length; i++) {
+    var file = path.join(engineDir, scripts[i]);
+    vm.runInContext(fs.readFileSync(file, "utf8"), context, {filename: file});
+  }
+
+  return context;
+}
+
+//game data has to be created inside the context, "instanceof Array" fails for arrays made outside it
+function contextData(context, data) {
+  return vm.runInContext("(" + JSON.stringify(data) + ")", context);
+}
+
+//scenes wait for a click so they keep running
+function sceneData(name, objects, background) {
+  return {
+    name: name,
+    type: "Scene",
+    backgroundImage: background,
+    objects: objects,
+    actions: [{name: "Wait", type: "Wait", waitType: "Forever"}]
+  };
+}
+
+//A scene that wasn't preloaded, e.g. when a save slot resumes into it, gets its assets after the first paint
+function testSceneAssetsLoadedAfterStart(done) {
+  var context = createContext(),
+      belle = context.belle;
+
+  var game = new belle.Game(contextData(context, {
+    assets: {
+      subdirs: {images: "", sounds: "", fonts: ""},
+      images: [{name: "background.png"}, {name: "portrait.png"}],
+      preload: [],
+      manifests: {"Scene 2": ["background.png", "portrait.png"]}
+    },
+    data: {
+      title: "Test",
+      width: 640,
+      height: 480,
+      textSpeed: 50,
+      scenes: [
+        sceneData("Scene 1", [], undefined),
+        sceneData("Scene 2", [{name: "Portrait", type: "Image", image: "portrait.png", x: 0, y: 0, width: 10, height: 10}], "background.png")
+      ]
+    }
+  }));
+
+  var assetManager = game.getAssetManager(),
+      model = game.getMainModel(),
+      scene = model.getScene("Scene 2");
+
+  assert.ok(assetManager.isLoaded(), "deferred assets shouldn't hold the game start");
+  assert.ok(! scene.background.image.getElement().getAttribute("src"), "the background was downloaded before its scene started");
+
+  //like loading a save slot: the scene is queued and started once the game resumes
+  model.setScene(scene);
+  model.resume();
+  assert.equal(model.getScene(), scene);
+  //starting a scene reloads its objects
+  var portrait = scene.getObjects()[0];
+  //the first paint happens before the downloads finish
+  scene.redraw = false;
+  portrait.redraw = false;
+
+  setTimeout(function() {
+    assert.ok(scene.background.image.getElement().complete, "the background wasn't fetched");
+    assert.ok(scene.redraw, "the scene wasn't repainted after its background loaded");
+    assert.ok(portrait.redraw, "the image wasn't repainted after it loaded");
+    done();
+  }, 10);
+}
+
+var tests = [testSceneAssetsLoadedAfterStart],
+    current = 0;
+
+function runNext() {
+  if (current >= tests.length) {
+    console.log("All " + tests.length + " tests passed");
+    return;
+  }
+
+  var test = tests[current++];
+  console.log(test.name);
+  test(runNext);
+}
+
+runNext();